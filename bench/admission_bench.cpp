@@ -0,0 +1,120 @@
+#include "plugpp-example/admission/AdmissionController.h"
+#include "plugpp-example/perf/Histogram.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+using example::admission::Action;
+using example::admission::AdmissionController;
+using example::admission::Limits;
+using example::perf::Histogram;
+
+constexpr int FRAME_MS = 50;
+constexpr int SIMULATED_MS = 120 * 1000;
+constexpr int VERDICT_TTL_MS = 10 * 60 * 1000;
+
+struct Result {
+    int maxStartsPerFrame;
+    int maxInflight;
+    int joined;
+    Histogram joinTimes;  ///< Milliseconds from the map change to getting access, in nanoseconds.
+    Histogram frameTimes; ///< Time spent in the controller per frame.
+};
+
+/// Every client reconnects right after a map change and resends its authentication request every frame
+/// until it gets admitted, the handshake then takes the given time (e.g., the ban lookup and the auth server)
+void simulate(const Limits& limits, const int clients, const int handshakeMs, Result& result) {
+    AdmissionController controller;
+    controller.setLimits(limits);
+    netadr_t addresses[AdmissionController::SLOTS] = {};
+    int admittedAt[AdmissionController::SLOTS];
+    bool connected[AdmissionController::SLOTS] = {};
+    std::fill(std::begin(admittedAt), std::end(admittedAt), -1);
+    for (int slot = 0; slot < clients; ++slot) {
+        addresses[slot].type = NA_IP;
+        addresses[slot].ip[0] = 10;
+        addresses[slot].ip[3] = static_cast<unsigned char>(slot);
+    }
+
+    const int start = FRAME_MS;
+    for (int now = start; now < SIMULATED_MS && result.joined < clients; now += FRAME_MS) {
+        int starts = 0;
+        const auto frameStart = std::chrono::steady_clock::now();
+        controller.advance(now);
+        for (int slot = 0; slot < clients; ++slot) {
+            if (connected[slot]) {
+                continue;
+            }
+            if (admittedAt[slot] >= 0) {
+                if (now - admittedAt[slot] >= handshakeMs) {
+                    controller.grant(slot);
+                    connected[slot] = true;
+                    ++result.joined;
+                    result.joinTimes.record(static_cast<std::uint64_t>(now - start) * 1000 * 1000);
+                }
+                continue;
+            }
+            // A tenth of the clients connect to the reserved slots
+            const bool reserved = slot % 10 == 0;
+            const auto decision = controller.admit(slot, addresses[slot], 1000 + slot, reserved);
+            if (decision.action == Action::ADMIT && decision.started) {
+                admittedAt[slot] = now;
+                ++starts;
+            }
+        }
+        const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - frameStart;
+        result.frameTimes.record(static_cast<std::uint64_t>(elapsed.count()));
+        result.maxStartsPerFrame = std::max(result.maxStartsPerFrame, starts);
+        result.maxInflight = std::max(result.maxInflight, controller.inflight());
+    }
+}
+
+void report(const char* label, const Limits& limits, const int clients, const int handshakeMs) {
+    Result result{};
+    simulate(limits, clients, handshakeMs, result);
+    constexpr double MS = 1000.0 * 1000.0;
+    std::printf("%-22s %6d %9d %6d/%-3d %8.0f %8.0f %8.0f %10llu\n",
+                label,
+                result.maxStartsPerFrame,
+                result.maxInflight,
+                result.joined,
+                clients,
+                static_cast<double>(result.joinTimes.percentile(0.5)) / MS,
+                static_cast<double>(result.joinTimes.percentile(0.99)) / MS,
+                static_cast<double>(result.joinTimes.max()) / MS,
+                static_cast<unsigned long long>(result.frameTimes.max()));
+}
+
+} // namespace
+
+/// Simulates everybody reconnecting after a map change, with and without the admission limits
+///
+/// The maximum number of handshakes started in a frame is what the frame time follows, the join times show
+/// the tail the maximum wait bounds.
+///
+/// Usage: admission-bench [clients] [maximum wait in ms]
+int main(int argc, char** argv) {
+    const int clients = std::clamp(argc > 1 ? std::atoi(argv[1]) : 64, 1, AdmissionController::SLOTS);
+    const int maxWait = argc > 2 ? std::atoi(argv[2]) : 10000;
+
+    for (const int handshakeMs : { 150, 3000 }) {
+        std::printf("%d clients, %d ms handshakes, %d ms frames:\n", clients, handshakeMs, FRAME_MS);
+        std::printf("%-22s %6s %9s %10s %8s %8s %8s %10s\n",
+                    "  limits",
+                    "starts",
+                    "inflight",
+                    "joined",
+                    "p50 [ms]",
+                    "p99 [ms]",
+                    "max [ms]",
+                    "frame [ns]");
+        report("  unlimited", { 0, 0, 0, VERDICT_TTL_MS }, clients, handshakeMs);
+        report("  in-flight 8", { 8, 0, maxWait, VERDICT_TTL_MS }, clients, handshakeMs);
+        report("  in-flight 8, 2/frame", { 8, 2, maxWait, VERDICT_TTL_MS }, clients, handshakeMs);
+    }
+    return 0;
+}
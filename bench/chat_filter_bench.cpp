@@ -0,0 +1,144 @@
+#include "plugpp-example/chat/WordFilter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// A small list of swearwords, the short ones only match whole words or the start of words
+const std::vector<std::string> SWEARWORDS = {
+    "fuck",      "shit",   "bitch",       "wanker",   "\\bass\\b",
+    "\\bcunt", "\\bfag", "\\bdick\\b", "\\bcrap\\b", "\\btit\\b",
+};
+
+/// Words of ordinary chat, many of them containing a short swearword
+constexpr const char* CLEAN_WORDS[] = {
+    "gg",    "wp",     "nice",    "shot",    "class",  "pass",  "grass",  "assist", "glass", "mass",
+    "title", "scrap",  "crappy",  "dickens", "fade",   "rush",  "b",      "flank",  "team",  "sniper",
+    "map",   "next",   "round",   "points",  "score",  "ez",    "noob",   "reload", "kills", "camping",
+    "455",   "1337",   "100",     "5v5",     "3rd",    "lol",   "brb",    "x",      "hi",    "petition",
+};
+
+std::string randomWord(std::mt19937& rng, const std::size_t minLength, const std::size_t maxLength) {
+    std::uniform_int_distribution<std::size_t> length(minLength, maxLength);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string word(length(rng), ' ');
+    for (auto& c : word) {
+        c = static_cast<char>(letter(rng));
+    }
+    return word;
+}
+
+template <typename Fn>
+void run(const char* name, const std::vector<std::string>& messages, const std::size_t rounds, Fn&& fn) {
+    std::size_t matched = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        for (const auto& message : messages) {
+            matched += fn(message) ? 1 : 0;
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double total = static_cast<double>(messages.size() * rounds);
+    std::printf("%-36s %14.0f messages/s %10zu matched\n", name, total / elapsed.count(), matched);
+}
+
+} // namespace
+
+/// Compares the chat filter against plain std::string::find, and shows how many clean messages a short list
+/// of swearwords hides with and without word boundaries
+///
+/// Usage: chat-filter-bench [patterns] [messages]
+int main(int argc, char** argv) {
+    const std::size_t patternCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    const std::size_t messageCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+
+    std::mt19937 rng(42);
+    std::vector<std::string> patterns;
+    patterns.reserve(patternCount);
+    for (std::size_t i = 0; i < patternCount; ++i) {
+        patterns.push_back(randomWord(rng, 5, 10));
+    }
+
+    // Chat-like messages, roughly 1% of them containing a pattern
+    std::uniform_int_distribution<std::size_t> wordCount(2, 12);
+    std::uniform_int_distribution<std::size_t> patternIndex(0, patternCount - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<std::string> messages;
+    messages.reserve(messageCount);
+    for (std::size_t i = 0; i < messageCount; ++i) {
+        std::string message;
+        for (std::size_t words = wordCount(rng); words > 0; --words) {
+            message += percent(rng) == 0 ? patterns[patternIndex(rng)] : randomWord(rng, 1, 7);
+            message += ' ';
+        }
+        messages.push_back(std::move(message));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const example::chat::WordFilter filter(patterns);
+    const std::chrono::duration<double, std::milli> compileTime = std::chrono::steady_clock::now() - start;
+    std::printf("%zu patterns compiled into %zu states in %.1f ms, %zu messages\n",
+                filter.patterns(),
+                filter.states(),
+                compileTime.count(),
+                messages.size());
+
+    run("std::string::find (single pattern)", messages, 50, [](const std::string& message) {
+        return message.find("swearword") != std::string::npos;
+    });
+    run("std::string::find (all patterns)", messages, 1, [&](const std::string& message) {
+        std::string lower(message);
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        return std::any_of(patterns.begin(), patterns.end(), [&](const std::string& pattern) {
+            return lower.find(pattern) != std::string::npos;
+        });
+    });
+    run("WordFilter (all patterns)", messages, 50, [&](const std::string& message) {
+        return filter.matches(message);
+    });
+
+    // Messages without any swearwords, every match is a false positive
+    std::uniform_int_distribution<std::size_t> cleanWord(0, std::size(CLEAN_WORDS) - 1);
+    std::vector<std::string> clean;
+    clean.reserve(messageCount);
+    for (std::size_t i = 0; i < messageCount; ++i) {
+        std::string message;
+        for (std::size_t words = wordCount(rng); words > 0; --words) {
+            message += CLEAN_WORDS[cleanWord(rng)];
+            message += ' ';
+        }
+        clean.push_back(std::move(message));
+    }
+    constexpr std::string_view BOUNDARY = example::chat::WordFilter::WORD_BOUNDARY;
+    std::vector<std::string> substrings;
+    for (std::string pattern : SWEARWORDS) {
+        for (std::size_t at; (at = pattern.find(BOUNDARY)) != std::string::npos;) {
+            pattern.erase(at, BOUNDARY.size());
+        }
+        substrings.push_back(std::move(pattern));
+    }
+    std::printf("\n%zu clean messages:\n", clean.size());
+    const std::vector<std::string>* lists[] = { &substrings, &SWEARWORDS };
+    for (const auto* list : lists) {
+        const example::chat::WordFilter swearwords(*list);
+        const auto hidden = static_cast<std::size_t>(
+            std::count_if(clean.begin(), clean.end(), [&](const std::string& message) {
+                return swearwords.matches(message);
+            }));
+        std::printf("  %-34s %10zu hidden (%.1f%% false positives)\n",
+                    list == &substrings ? "swearwords anywhere in words" : "swearwords with word boundaries",
+                    hidden,
+                    100.0 * static_cast<double>(hidden) / static_cast<double>(clean.size()));
+    }
+    return 0;
+}
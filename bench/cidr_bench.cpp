@@ -0,0 +1,192 @@
+#include "plugpp-example/net/CidrTrie.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using example::net::CidrTrie;
+using example::net::IpAction;
+using example::net::IpKey;
+using example::net::IpRule;
+
+/// Prefix lengths of IPv4 ranges roughly as seen in the routing tables and the hosting-provider lists
+std::uint32_t randomLength4(std::mt19937& rng) {
+    std::uniform_int_distribution<int> percent(0, 99);
+    const int p = percent(rng);
+    if (p < 55) {
+        return 24;
+    }
+    if (p < 80) {
+        return std::uniform_int_distribution<std::uint32_t>(17, 23)(rng);
+    }
+    if (p < 92) {
+        return std::uniform_int_distribution<std::uint32_t>(12, 16)(rng);
+    }
+    if (p < 97) {
+        return std::uniform_int_distribution<std::uint32_t>(25, 32)(rng);
+    }
+    return std::uniform_int_distribution<std::uint32_t>(8, 11)(rng);
+}
+
+std::uint32_t randomLength6(std::mt19937& rng) {
+    constexpr std::uint32_t LENGTHS[] = { 29, 32, 32, 32, 36, 40, 44, 48, 48, 48, 56, 64 };
+    return LENGTHS[std::uniform_int_distribution<std::size_t>(0, std::size(LENGTHS) - 1)(rng)];
+}
+
+/// Random global unicast address, 2000::/3
+IpKey randomKey6(std::mt19937& rng) {
+    std::uniform_int_distribution<std::uint64_t> random64;
+    return { random64(rng) >> 3 | std::uint64_t{ 1 } << 61, random64(rng) };
+}
+
+IpKey randomKey4(std::mt19937& rng) {
+    return { 0, std::uint64_t{ 0xffff } << 32 | std::uniform_int_distribution<std::uint32_t>()(rng) };
+}
+
+IpAction randomAction(std::mt19937& rng) {
+    const int p = std::uniform_int_distribution<int>(0, 99)(rng);
+    return p < 85 ? IpAction::DENY : p < 95 ? IpAction::ALLOW : IpAction::RESERVED;
+}
+
+std::string toString(const IpRule& rule) {
+    char text[128];
+    const auto action = example::net::IP_ACTION_NAMES[static_cast<std::size_t>(rule.action)];
+    if (rule.length >= 96 && rule.key.hi == 0 && rule.key.lo >> 32 == 0xffff) {
+        const auto ip = static_cast<std::uint32_t>(rule.key.lo);
+        std::snprintf(text,
+                      sizeof(text),
+                      "%.*s %u.%u.%u.%u/%u",
+                      static_cast<int>(action.size()),
+                      action.data(),
+                      ip >> 24,
+                      ip >> 16 & 0xff,
+                      ip >> 8 & 0xff,
+                      ip & 0xff,
+                      rule.length - 96);
+    } else {
+        std::snprintf(text,
+                      sizeof(text),
+                      "%.*s %x:%x:%x:%x::/%u",
+                      static_cast<int>(action.size()),
+                      action.data(),
+                      static_cast<unsigned>(rule.key.hi >> 48),
+                      static_cast<unsigned>(rule.key.hi >> 32 & 0xffff),
+                      static_cast<unsigned>(rule.key.hi >> 16 & 0xffff),
+                      static_cast<unsigned>(rule.key.hi & 0xffff),
+                      rule.length);
+    }
+    return text;
+}
+
+/// Reference longest-prefix match over all the rules
+IpAction linearLookup(const std::vector<IpRule>& rules, const IpKey& key) {
+    IpAction action = IpAction::NONE;
+    int best = -1;
+    for (const IpRule& rule : rules) {
+        const IpKey prefix = example::net::detail::mask(key, rule.length);
+        if (prefix.hi == rule.key.hi && prefix.lo == rule.key.lo && rule.length >= best) {
+            best = rule.length;
+            action = rule.action;
+        }
+    }
+    return action;
+}
+
+double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+/// Measures loading the IP policy and looking addresses up in it
+///
+/// Usage: cidr-bench [IPv4 prefixes] [IPv6 prefixes] [lookups]
+int main(int argc, char** argv) {
+    const std::size_t count4 = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    const std::size_t count6 = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000;
+    const std::size_t lookupCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000000;
+
+    std::mt19937 rng(42);
+    using example::net::detail::mask;
+    std::vector<IpRule> rules;
+    rules.reserve(count4 + count6);
+    for (std::size_t i = 0; i < count4 + count6; ++i) {
+        const bool ipv6 = i >= count4;
+        const std::uint32_t length = ipv6 ? randomLength6(rng) : 96 + randomLength4(rng);
+        const IpKey key = mask(ipv6 ? randomKey6(rng) : randomKey4(rng), length);
+        rules.push_back({ key, static_cast<std::uint8_t>(length), randomAction(rng) });
+    }
+
+    // Half of the addresses fall into the listed ranges, a fifth of them are IPv6
+    std::vector<IpKey> addresses;
+    addresses.reserve(lookupCount);
+    std::uniform_int_distribution<std::size_t> ruleIndex(0, rules.size() - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (std::size_t i = 0; i < lookupCount; ++i) {
+        IpKey key = percent(rng) < 20 ? randomKey6(rng) : randomKey4(rng);
+        if (percent(rng) < 50) {
+            // Keep the host bits, take the network from a rule
+            const IpRule& rule = rules[ruleIndex(rng)];
+            const IpKey network = mask(key, rule.length);
+            key = { rule.key.hi | (key.hi ^ network.hi), rule.key.lo | (key.lo ^ network.lo) };
+        }
+        addresses.push_back(key);
+    }
+
+    const std::string path = "cidr-bench.txt";
+    if (std::FILE* file = std::fopen(path.c_str(), "w")) {
+        for (const IpRule& rule : rules) {
+            std::fprintf(file, "%s\n", toString(rule).c_str());
+        }
+        std::fclose(file);
+    } else {
+        std::fprintf(stderr, "Can't write '%s'\n", path.c_str());
+        return 1;
+    }
+    std::remove((path + ".bin").c_str());
+
+    auto start = std::chrono::steady_clock::now();
+    const auto compiled = CidrTrie::fromFile(path);
+    std::printf("%zu rules compiled into %zu nodes (%zu KiB) in %.1f ms\n",
+                compiled->rules(),
+                compiled->nodes(),
+                compiled->nodes() * sizeof(CidrTrie::Node) / 1024,
+                millisecondsSince(start));
+    start = std::chrono::steady_clock::now();
+    const auto trie = CidrTrie::fromFile(path);
+    std::printf(
+        "Compiled trie %s in %.2f ms\n", trie->mapped() ? "mapped" : "rebuilt", millisecondsSince(start));
+
+    std::size_t mismatches = 0;
+    const std::size_t checked = std::min<std::size_t>(addresses.size(), 10000);
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < checked; ++i) {
+        mismatches += linearLookup(rules, addresses[i]) != trie->lookup(addresses[i]) ? 1 : 0;
+    }
+    const double linearMs = millisecondsSince(start);
+    std::printf("%-24s %14.0f lookups/s\n", "linear scan", static_cast<double>(checked) / linearMs * 1e3);
+
+    std::size_t matched = 0;
+    start = std::chrono::steady_clock::now();
+    for (const IpKey& address : addresses) {
+        matched += trie->lookup(address) != IpAction::NONE ? 1 : 0;
+    }
+    const double trieMs = millisecondsSince(start);
+    std::printf("%-24s %14.0f lookups/s %10zu matched\n",
+                "CidrTrie",
+                static_cast<double>(addresses.size()) / trieMs * 1e3,
+                matched);
+    if (mismatches != 0) {
+        std::printf("%zu of %zu lookups differ from the linear scan\n", mismatches, checked);
+    }
+
+    std::remove(path.c_str());
+    std::remove((path + ".bin").c_str());
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+#include "plugpp-example/gsc/Usercalls.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The script side of the plugin API, every usercall takes a single integer
+int scriptParam = 0;
+int scriptParamCount = 1;
+long long scriptResults = 0;
+
+} // namespace
+
+extern "C" {
+
+int Plugin_Scr_GetNumParam() {
+    return scriptParamCount;
+}
+
+int Plugin_Scr_GetInt(unsigned int) {
+    return scriptParam;
+}
+
+void Plugin_Scr_AddInt(int value) {
+    scriptResults += value;
+}
+
+void Plugin_Scr_Error(const char* string) {
+    std::fprintf(stderr, "%s\n", string);
+    std::exit(1);
+}
+}
+
+namespace {
+
+using example::gsc::makeFunctions;
+using example::gsc::usercall;
+
+/// Names of the usercalls of a typical mod
+constexpr std::string_view NAMES[] = {
+    "player_get_kills",      "player_get_deaths",     "player_get_score",      "player_set_score",
+    "player_get_rank",       "player_set_rank",       "player_get_prestige",   "player_get_xp",
+    "player_add_xp",         "player_get_money",      "player_add_money",      "player_get_team",
+    "player_is_admin",       "player_is_vip",         "player_get_streak",     "player_reset_streak",
+    "map_get_votes",         "map_add_vote",          "map_get_next",          "map_get_time_left",
+    "stats_get_accuracy",    "stats_get_headshots",   "stats_get_playtime",    "stats_save",
+    "weapon_get_unlocks",    "weapon_unlock",         "weapon_get_camo",       "weapon_set_camo",
+    "server_get_uptime",     "server_get_players",    "server_is_ranked",      "server_get_mode",
+};
+constexpr std::size_t COUNT = std::size(NAMES);
+
+/// Number of calls dispatched over and over
+constexpr std::size_t CALL_POOL = 4096;
+/// Number of distinct usercalls in the simulated script loop, taken from the end of the chain
+constexpr std::size_t LOOP_LENGTH = 8;
+
+struct Handlers {
+    template <std::size_t I>
+    int handler(const int value) {
+        return value + static_cast<int>(I);
+    }
+};
+
+template <std::size_t... I>
+constexpr auto makeTable(std::index_sequence<I...>) {
+    return makeFunctions<Handlers>(usercall<&Handlers::handler<I>>(NAMES[I])...);
+}
+
+/// What a handler set without a dispatch table ends up as - string compares one after another
+template <std::size_t... I>
+bool naiveDispatch(Handlers& handlers, const std::string& name, std::index_sequence<I...>) {
+    return ((name == NAMES[I] &&
+             (Plugin_Scr_GetNumParam() == 1 || (Plugin_Scr_Error("usage"), false)) &&
+             (Plugin_Scr_AddInt(handlers.handler<I>(Plugin_Scr_GetInt(0))), true)) ||
+            ...);
+}
+
+/// Dispatches the calls over and over, they stay in the cache like the names of a script's hot loop
+template <typename Dispatch>
+void measure(const char* label,
+             const std::vector<std::string>& calls,
+             const std::size_t count,
+             Dispatch&& dispatch) {
+    scriptResults = 0;
+    std::size_t handled = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        handled += dispatch(calls[i % calls.size()]) ? 1 : 0;
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-28s %8.1f ns/call %12zu handled %16lld\n",
+                label,
+                elapsed.count() / static_cast<double>(count),
+                handled,
+                scriptResults);
+}
+
+} // namespace
+
+/// Compares the perfect-hash usercall table with a chain of string compares
+///
+/// Usage: usercall-bench [calls] [percent of unknown names]
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    const int unknownPercent = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    // Random names defeat the branch predictors, a script's loop repeats the same few usercalls in order
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> nameIndex(0, COUNT - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<std::string> randomCalls;
+    std::vector<std::string> loopCalls;
+    for (std::size_t i = 0; i < CALL_POOL; ++i) {
+        std::string name(NAMES[nameIndex(rng)]);
+        if (percent(rng) < unknownPercent) {
+            name += "_other_plugin"; // Handled by another plugin
+        }
+        randomCalls.push_back(std::move(name));
+        loopCalls.emplace_back(NAMES[(i * 5) % LOOP_LENGTH + COUNT - LOOP_LENGTH]);
+    }
+
+    static constexpr auto TABLE = makeTable(std::make_index_sequence<COUNT>{});
+    Handlers handlers;
+    scriptParam = 1;
+    for (const auto* calls : { &randomCalls, &loopCalls }) {
+        std::printf("%s:\n", calls == &randomCalls ? "Random usercalls" : "Usercalls repeated in a loop");
+        measure("  if/else string compare", *calls, count, [&](const std::string& name) {
+            return naiveDispatch(handlers, name, std::make_index_sequence<COUNT>{});
+        });
+        measure("  perfect hash table", *calls, count, [&](const std::string& name) {
+            return TABLE.call(handlers, name);
+        });
+    }
+    return 0;
+}
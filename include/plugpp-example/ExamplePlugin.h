@@ -6,7 +6,31 @@
 #include <cod4-plugpp/utils/netUtils.hpp>
 #include <cod4-plugpp/utils/stringUtils.hpp>
 
+#include "plugpp-example/admission/AdmissionController.h"
+#include "plugpp-example/anticheat/MoveAnalyzer.h"
+#include "plugpp-example/ban/BanService.h"
+#include "plugpp-example/chat/ChatFilter.h"
+#include "plugpp-example/console/Commands.h"
+#include "plugpp-example/console/Cvar.h"
+#include "plugpp-example/gsc/Usercalls.h"
+#include "plugpp-example/io/log.h"
 #include "plugpp-example/io/print.h"
+#include "plugpp-example/metrics/Metrics.h"
+#include "plugpp-example/metrics/MetricsExporter.h"
+#include "plugpp-example/names/NameCache.h"
+#include "plugpp-example/net/FloodLimiter.h"
+#include "plugpp-example/net/IpPolicy.h"
+#include "plugpp-example/net/QueryCache.h"
+#include "plugpp-example/perf/HookProfiler.h"
+#include "plugpp-example/screenshot/ScreenshotPipeline.h"
+#include "plugpp-example/sched/FrameClock.h"
+#include "plugpp-example/sched/Scheduler.h"
+#include "plugpp-example/state/StateSnapshot.h"
+#include "plugpp-example/state/StateWriter.h"
+#include "plugpp-example/stats/MatchStats.h"
+#include "plugpp-example/stats/MatchSummaryWriter.h"
+#include "plugpp-example/trace/TraceRecorder.h"
+#include "plugpp-example/userinfo/UserinfoCache.h"
 
 template <typename T>
 struct fmt::formatter<plugpp::Optional<T>> {
@@ -29,10 +53,315 @@ namespace example {
 class ExamplePlugin final : public plugpp::Plugin {
 public:
     /// Constructor gets called when the plugin is loaded
-    explicit ExamplePlugin(const std::string& greet) { io::println("^2{}", greet); }
+    explicit ExamplePlugin(const std::string& greet)
+        : m_printLinesPerFrame("example_print_lines_per_frame",
+                               32,
+                               1,
+                               io::ConsoleQueue::CAPACITY,
+                               "Maximum number of console lines the plugin prints per server frame")
+        , m_printBytesPerFrame("example_print_bytes_per_frame",
+                               4096,
+                               io::ConsoleQueue::LINE_SIZE,
+                               1024 * 1024,
+                               "Maximum number of characters the plugin prints per server frame")
+        , m_printOverflowPolicy("example_print_overflow",
+                                static_cast<int>(io::OverflowPolicy::COALESCE),
+                                static_cast<int>(io::OverflowPolicy::DROP),
+                                static_cast<int>(io::OverflowPolicy::COALESCE),
+                                "What to do with console lines when the print queue is full (0 = drop, 1 = "
+                                "drop and print the number of suppressed lines)")
+        , m_banStorePath("example_ban_store", "bans.dat", "Path to the file the bans are stored in")
+        , m_banLookupTimeout("example_ban_lookup_timeout",
+                             5000,
+                             0,
+                             60000,
+                             "Milliseconds a connecting player waits for the ban lookup before being let in")
+        , m_bans(ban::BanService::Settings{
+              m_banStorePath.get(), 2, 1024, 4096, 10 * 60 * 1000, 60 * 1000 })
+        , m_chatWordList("example_chat_wordlist",
+                         "wordlist.txt",
+                         "Path to the file with the patterns of chat messages to hide")
+        , m_ipPolicyPath("example_ip_policy",
+                         "ippolicy.txt",
+                         "Path to the file with the allowed, denied and reserved slot address ranges")
+        , m_udpQueryRate("example_udp_query_rate",
+                         4,
+                         0,
+                         10000,
+                         "getstatus/getinfo packets per second allowed per IP address (0 = unlimited)")
+        , m_udpQueryBurst(
+              "example_udp_query_burst", 10, 1, 10000, "Burst of getstatus/getinfo packets allowed")
+        , m_udpConnectRate("example_udp_connect_rate",
+                           2,
+                           0,
+                           10000,
+                           "getchallenge/connect packets per second allowed from a single IP address "
+                           "(0 = unlimited)")
+        , m_udpConnectBurst(
+              "example_udp_connect_burst", 5, 1, 10000, "Burst of getchallenge/connect packets allowed")
+        , m_udpOtherRate("example_udp_other_rate",
+                         2,
+                         0,
+                         10000,
+                         "Other connectionless packets per second allowed from a single IP address "
+                         "(0 = unlimited)")
+        , m_udpOtherBurst(
+              "example_udp_other_burst", 5, 1, 10000, "Burst of other connectionless packets allowed")
+        , m_udpReplyRate("example_udp_reply_rate",
+                         16384,
+                         0,
+                         1000000,
+                         "Bytes of connectionless replies per second sent to a single IP address "
+                         "(0 = unlimited)")
+        , m_udpReplyBurst(
+              "example_udp_reply_burst", 65536, 1, 2000000, "Burst of connectionless reply bytes allowed")
+        , m_queryCacheTtl("example_query_cache_ttl",
+                          1000,
+                          0,
+                          60000,
+                          "Milliseconds a getinfo/getstatus reply is reused for (0 = don't cache)")
+        , m_tasksPerFrame("example_tasks_per_frame",
+                          64,
+                          1,
+                          100000,
+                          "Maximum number of scheduled tasks run per server frame, the rest runs in the next "
+                          "frames")
+        , m_traceEnabled("example_trace",
+                         0,
+                         0,
+                         1,
+                         "Records the plugin callbacks into a binary trace (1 = record, 0 = stop recording)")
+        , m_tracePath("example_trace_path", "trace/example.trace", "Path to the trace file being recorded")
+        , m_moveWindowsPerFrame("example_moves_windows_per_frame",
+                                64,
+                                0,
+                                4096,
+                                "Maximum number of windows of 16 move commands analyzed per server frame "
+                                "(0 = don't analyze)")
+        , m_minRate("example_min_rate", 5000, 0, 100000, "Lowest rate a client may use (0 = any)")
+        , m_minSnaps("example_min_snaps", 10, 0, 1000, "Lowest snaps a client may use (0 = any)")
+        , m_screenshotStore("example_screenshot_store",
+                            "",
+                            "Directory the screenshots are hard linked into under the hash of their content "
+                            "(empty = don't store)")
+        , m_screenshots(screenshot::ScreenshotPipeline::Settings{ 2, 8, 64, 1024, 0.05 })
+        , m_matchSummaries("example_match_summaries",
+                           "",
+                           "Directory the summaries of the finished matches are written into (empty = don't "
+                           "write)")
+        , m_telemetry(m_metrics)
+        , m_metricsTarget("example_metrics_target",
+                          "",
+                          "File the metrics are written into in the Prometheus text format, or "
+                          "unix:<path> of a socket they're sent to (empty = don't export)")
+        , m_metricsInterval(
+              "example_metrics_interval", 5000, 100, 600000, "Milliseconds between the exported metrics")
+        , m_metricsExporter(m_metrics)
+        , m_admissionInflight("example_admission_inflight",
+                              8,
+                              0,
+                              64,
+                              "Connection handshakes in progress at a time, the other clients wait "
+                              "(0 = unlimited)")
+        , m_admissionPerFrame("example_admission_per_frame",
+                              2,
+                              0,
+                              64,
+                              "Connection handshakes started per server frame (0 = unlimited)")
+        , m_admissionMaxWait("example_admission_max_wait",
+                             10000,
+                             0,
+                             120000,
+                             "Milliseconds after which a waiting client is let in over the in-flight limit "
+                             "(0 = never)")
+        , m_admissionVerdictTtl("example_admission_verdict_ttl",
+                                10 * 60 * 1000,
+                                0,
+                                24 * 60 * 60 * 1000,
+                                "Milliseconds the outcome of a handshake is reused for the same IP address "
+                                "and player ID (0 = don't reuse)")
+#ifdef PLUGPP_EXAMPLE_PROFILING
+        , m_frameBudget("example_perf_frame_budget",
+                        1000,
+                        1,
+                        1000000,
+                        "Microseconds the plugin may spend in its callbacks per server frame")
+#endif
+    {
+        io::println("^2{}", greet);
+
+        m_floodLimiter.restore(m_restored);
+        m_moves.restore(m_restored);
+        m_userinfo.restore(m_restored);
+        m_bans.restore(m_restored, Plugin_Milliseconds());
+        m_matchStats.restore(m_restored);
+        for (int slot = 0; slot < static_cast<int>(names::NameCache::SLOTS); ++slot) {
+            updateName(slot);
+        }
+        if (m_matchStats.state().map[0] == '\0') {
+            rollOverMatch(); // Loaded in the middle of a map
+        }
+        if (!m_restored.empty()) {
+            spdlog::info("Continuing with the state of the previous plugin instance (reload {}), {} sections "
+                         "used in place, {} rebuilt",
+                         m_restored.generation(),
+                         m_restored.adopted(),
+                         m_restored.restored());
+        }
+
+        console::commands().add("example_reload_wordlist", 80, [this](const console::CommandArgs&) {
+            if (!m_chatFilter.reload(m_chatWordList.get())) {
+                io::println("The word list is already being reloaded");
+            }
+        });
+        m_chatFilter.reload(m_chatWordList.get());
+
+        console::commands().add("example_reload_ippolicy", 80, [this](const console::CommandArgs&) {
+            if (!m_ipPolicy.reload(m_ipPolicyPath.get())) {
+                io::println("The IP policy is already being reloaded");
+            }
+        });
+        m_ipPolicy.reload(m_ipPolicyPath.get());
+
+        console::commands().add("example_udp_stats", 80, [this](const console::CommandArgs&) {
+            const auto& stats = m_floodLimiter.stats();
+            io::println("Connectionless packets passed: {}, dropped queries: {}, dropped connects: {}, "
+                        "dropped other: {}, evicted addresses: {}, throttled replies: {}",
+                        stats.passed,
+                        stats.dropped[static_cast<std::size_t>(net::PacketClass::QUERY)],
+                        stats.dropped[static_cast<std::size_t>(net::PacketClass::CONNECT)],
+                        stats.dropped[static_cast<std::size_t>(net::PacketClass::OTHER)],
+                        stats.evictions,
+                        stats.throttledReplies);
+            const auto& cache = m_queryCache.stats();
+            io::println("Query cache hits: {}, misses: {}, replies learned: {}, invalidations: {}",
+                        cache.hits,
+                        cache.misses,
+                        cache.learned,
+                        cache.invalidations);
+        });
+
+        console::commands().add("example_moves", 80, [this](const console::CommandArgs& args) {
+            for (int slot = 0; slot < static_cast<int>(anticheat::MoveAnalyzer::SLOTS); ++slot) {
+                if (args.count() > 1 && args[1] != std::to_string(slot)) {
+                    continue;
+                }
+                const anticheat::MoveStats& stats = m_moves.stats(slot);
+                if (stats.windows == 0) {
+                    continue;
+                }
+                io::println("Slot {}: {} commands ({} not analyzed), max angle change {}, {} spikes, "
+                            "{} snaps, interval {:.1f} ms +- {:.1f} ms, {} out of order",
+                            slot,
+                            stats.commands,
+                            stats.skipped,
+                            stats.maxDelta,
+                            stats.spikes,
+                            stats.snaps,
+                            stats.meanInterval,
+                            stats.jitter,
+                            stats.nonMonotonic);
+            }
+        });
+
+        console::commands().add("example_admission", 80, [this](const console::CommandArgs&) {
+            const auto& stats = m_admission.stats();
+            const perf::Histogram& waits = m_admission.waits();
+            io::println("Handshakes in flight: {}, waiting: {}; admitted: {} ({} prioritized, {} over the "
+                        "limits after the maximum wait), deferred requests: {}, rejected by a remembered "
+                        "kick: {}, timed out: {}; wait p50 {} ms, p99 {} ms, max {} ms",
+                        m_admission.inflight(),
+                        m_admission.waiting(),
+                        stats.admitted,
+                        stats.prioritized,
+                        stats.overdue,
+                        stats.deferred,
+                        stats.rejected,
+                        stats.timedOut,
+                        waits.percentile(0.5) / 1000000,
+                        waits.percentile(0.99) / 1000000,
+                        waits.max() / 1000000);
+        });
+
+        console::commands().add("example_log_stats", 80, [](const console::CommandArgs&) {
+            const io::LogStats log = io::logStats();
+            const io::ConsoleQueueStats console = io::consoleQueue().stats();
+            io::println("Log messages overrun: {}, sampled out: {}, rate limited: {}; console lines printed: "
+                        "{}, dropped: {}, truncated: {}",
+                        log.overrun,
+                        log.sampled,
+                        log.rateLimited,
+                        console.printed,
+                        console.dropped,
+                        console.truncated);
+        });
+
+        console::commands().add("example_screenshots", 80, [this](const console::CommandArgs& args) {
+            if (args.count() > 1) {
+                const int slot = userinfo::Userinfo::toInt(args[1]).value_or(-1);
+                const client_t* client = slot >= 0 && slot < userinfo::UserinfoCache::SLOTS
+                                             ? Plugin_GetClientForClientNum(slot)
+                                             : nullptr;
+                if (!client || client->state < CS_CONNECTED) {
+                    io::println("No player in slot {}", args[1]);
+                    return;
+                }
+                m_screenshots.forEachOf(client->playerid, [](const screenshot::IndexEntry& entry) {
+                    io::println("{:016x} {} bytes {}x{}{}",
+                                entry.hash,
+                                entry.size,
+                                entry.width,
+                                entry.height,
+                                describeFlags(entry.flags));
+                });
+                return;
+            }
+            const auto& stats = m_screenshots.stats();
+            io::println("Screenshots submitted: {}, deferred: {}, skipped: {}, processed: {}, failed: {}, "
+                        "flagged: {}, pending: {}",
+                        stats.submitted,
+                        stats.deferred,
+                        stats.skipped,
+                        stats.processed,
+                        stats.failed,
+                        stats.flagged,
+                        m_screenshots.pending());
+            for (std::size_t i = 0; i < static_cast<std::size_t>(screenshot::Stage::COUNT); ++i) {
+                const perf::Histogram& times = m_screenshots.stageTimes(static_cast<screenshot::Stage>(i));
+                io::println("  {:<8} p50 {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms",
+                            screenshot::STAGE_NAMES[i],
+                            static_cast<double>(times.percentile(0.5)) / 1e6,
+                            static_cast<double>(times.percentile(0.99)) / 1e6,
+                            static_cast<double>(times.max()) / 1e6);
+            }
+        });
+
+        m_scheduler.schedulePeriodic(10 * 1000, [] { io::println("10 second timer"); });
+        m_scheduler.schedulePeriodic(30 * 1000, [] { io::flushLog(); });
+        sampleMetrics();
+        m_scheduler.schedulePeriodic(1000, [this] { sampleMetrics(); });
+
+#ifdef PLUGPP_EXAMPLE_PROFILING
+        console::commands().add("example_perf", 80, [](const console::CommandArgs& args) {
+            if (args.count() > 1 && args[1] == "reset") {
+                perf::profiler().reset();
+                return;
+            }
+            writeProfile([](const std::string& line) { io::println("{}", line); });
+        });
+        m_scheduler.schedulePeriodic(60 * 1000, [] {
+            writeProfile([](const std::string& line) { spdlog::debug("{}", line); });
+        });
+#endif
+    }
 
     /// Destructor gets called when the plugin is unloaded or when the server quits
-    virtual ~ExamplePlugin() noexcept = default;
+    virtual ~ExamplePlugin() noexcept {
+        console::commands().clear();
+        saveState();
+        io::stopLogging();
+        io::consoleQueue().flush();
+    }
 
     /// Gets called whenever a client sends a chat-message
     ///
@@ -43,18 +372,20 @@ public:
     /// the message from sending.
     virtual plugpp::MessageVisibility
     onMessageSent(const std::string& message, int slot, int mode) final override {
+        EXAMPLE_PROFILE_HOOK(ON_MESSAGE_SENT);
         auto client = plugpp::getClientBySlot(slot);
         if (!client) {
             return plugpp::MessageVisibility::SHOW;
         }
-        client_t* cl = *client;
         io::println("Player {} sent a {} chat-message: {}",
-                    plugpp::removeColor(cl->name),
+                    m_names.name(slot),
                     mode == 1 ? "team" : "public",
                     message);
 
-        const bool isSwearWord = message.find("swearword") == std::string::npos;
-        return isSwearWord ? plugpp::MessageVisibility::SHOW : plugpp::MessageVisibility::HIDE;
+        const bool isFiltered = m_chatFilter.matches(message);
+        (isFiltered ? m_telemetry.chatHidden : m_telemetry.chatShown).add();
+        m_trace.chat(slot, mode, message, isFiltered);
+        return isFiltered ? plugpp::MessageVisibility::HIDE : plugpp::MessageVisibility::SHOW;
     }
 
     virtual plugpp::PluginInfo onPluginInfoRequest() final override {
@@ -79,11 +410,28 @@ public:
     /// @returns @ref plugpp::NoKick to allow the player to join or @ref plugpp::Kick to kick the player with
     /// the given reason.
     virtual plugpp::Kick onPlayerConnect(int slot, netadr_t* netaddr, const char* userinfo) final override {
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_CONNECT);
         io::println("Client in slot {} joining the server from IP address {} with userinfo: {}",
                     slot,
                     plugpp::toStr(netaddr),
                     userinfo);
-        return slot == 20 ? plugpp::Kick("Only ^1very special ^7players can join this slot") : plugpp::NoKick;
+        m_trace.connect(slot, *netaddr);
+        m_telemetry.connects.add();
+        m_admission.release(slot); // A new client in the slot
+        if (m_ipPolicy.lookup(*netaddr) == net::IpAction::DENY) {
+            m_telemetry.kicksIpPolicy.add();
+            return plugpp::Kick("Connections from your network are not allowed");
+        }
+
+        m_userinfo.reset(slot);
+        if (std::string reason = checkRates(m_userinfo.update(slot, userinfo)); !reason.empty()) {
+            m_telemetry.kicksRates.add();
+            return plugpp::Kick(std::move(reason));
+        }
+        updateName(slot);
+        m_queryCache.invalidate();
+        m_matchStats.join(slot);
+        return plugpp::NoKick;
     }
 
     /// Gets called whenever a client disconnects from the server
@@ -92,19 +440,35 @@ public:
     /// @param reason Reason for the disconnect (can be a kick message, EXE_DISCONNECT or a violation
     /// message).
     virtual void onPlayerDisconnect(client_t* client, const char* reason) final override {
-        io::println("Client {} just left the server. Reason: {}", plugpp::removeColor(client->name), reason);
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_DISCONNECT);
+        const int slot = Plugin_GetClientNumForClient(client);
+        m_scheduler.cancelOwner(slot);
+        m_trace.event(trace::RecordType::DISCONNECT, slot);
+        m_queryCache.invalidate();
+        m_matchStats.leave(slot);
+        m_admission.release(slot);
+        m_moves.reset(slot);
+        m_userinfo.reset(slot);
+        io::println("Client {} just left the server. Reason: {}", m_names.name(slot), reason);
+        m_names.reset(slot);
     }
 
     /// Gets called when a player gets banned (can be a result of e.g., calling the banUser/banClient command)
     ///
     /// @param banInfo A structure containing information about the ban.
     virtual void onPlayerAddBan(baninfo_t* banInfo) final override {
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_ADD_BAN);
+        m_bans.addBan({ banInfo->playerid, banInfo->steamid },
+                      banInfo->message,
+                      banInfo->duration,
+                      Plugin_Milliseconds());
+        m_admission.forget(banInfo->playerid);
         io::println("Player {} with player ID {} got {} banned for '{}'. Banned by admin {} with steam ID {}",
-                    plugpp::removeColor(banInfo->playername),
+                    names::StrippedName(banInfo->playername),
                     banInfo->playerid,
                     banInfo->duration == 0 ? "permanently" : "temporarily",
                     banInfo->message,
-                    plugpp::removeColor(banInfo->adminname),
+                    names::StrippedName(banInfo->adminname),
                     banInfo->adminsteamid);
     }
 
@@ -113,10 +477,13 @@ public:
     ///
     /// @param banInfo A structure containing information about the ban.
     virtual void onPlayerRemoveBan(baninfo_t* banInfo) final override {
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_REMOVE_BAN);
+        m_bans.removeBan({ banInfo->playerid, banInfo->steamid }, Plugin_Milliseconds());
+        m_admission.forget(banInfo->playerid);
         io::println("Player {} with player ID {} got unbanned by admin {} with steam ID {}",
-                    plugpp::removeColor(banInfo->playername),
+                    names::StrippedName(banInfo->playername),
                     banInfo->playerid,
-                    plugpp::removeColor(banInfo->adminname),
+                    names::StrippedName(banInfo->adminname),
                     banInfo->adminsteamid);
     }
 
@@ -141,13 +508,48 @@ public:
                                              uint64_t& playerid,
                                              uint64_t& steamid,
                                              bool& returnNow) final override {
-        (void)returnNow;
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_GOT_AUTH_INFO);
+        const int now = Plugin_Milliseconds();
+        const int slot = Plugin_GetClientNumForClient(cl);
+        const bool reserved = m_ipPolicy.lookup(*from) == net::IpAction::RESERVED;
+        const admission::Decision decision = m_admission.admit(slot, *from, playerid, reserved);
+        if (decision.action == admission::Action::DEFER) {
+            // Too many handshakes in flight, the client asks again with its next authentication request
+            m_telemetry.admissionsDeferred.add();
+            returnNow = true;
+            return plugpp::NoKick;
+        }
+        if (decision.action == admission::Action::REJECT) {
+            m_telemetry.admissionsRejected.add();
+            return plugpp::Kick(std::string(decision.reason));
+        }
+        if (decision.started) {
+            m_telemetry.admissionsStarted.add();
+            m_telemetry.admissionWaits.observe(static_cast<std::uint64_t>(decision.waitedMs));
+        }
+
+        const ban::PlayerKey key{ playerid, steamid };
+        const auto verdict = m_bans.lookup(key, now);
+        if (!verdict) {
+            if (m_bans.pendingFor(key, now) < m_banLookupTimeout.get()) {
+                // Park the client, this callback gets called again with the next authentication request
+                returnNow = true;
+                return plugpp::NoKick;
+            }
+            EXAMPLE_LOG_RATE_LIMITED(warn,
+                                     10,
+                                     10 * 1000,
+                                     "Ban lookup for player ID {} timed out, letting the player in",
+                                     playerid);
+        }
+
         io::println("Client {} connecting from {} authenticated with player ID {} and steam ID {}",
-                    plugpp::removeColor(cl->name),
+                    m_names.name(slot),
                     plugpp::toStr(from),
                     playerid,
                     steamid);
-        return plugpp::NoKick;
+        m_trace.auth(slot, playerid, steamid, verdict && verdict->banned);
+        return verdict ? kickBanned(slot, *verdict) : plugpp::NoKick;
     }
 
     /// Gets called whenever a client wants to connects to the server
@@ -158,11 +560,13 @@ public:
     /// @returns @ref plugpp::NoKick to allow the player to join or @ref plugpp::Kick to kick the player with
     /// the given reason.
     virtual plugpp::Kick onPlayerGetBanStatus(baninfo_t* banInfo) final override {
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_GET_BAN_STATUS);
         io::println("Checking ban status for player {} with player ID {} and steam ID {}",
-                    plugpp::removeColor(banInfo->playername),
+                    names::StrippedName(banInfo->playername),
                     banInfo->playerid,
                     banInfo->steamid);
-        return plugpp::NoKick;
+        const auto verdict = m_bans.lookup({ banInfo->playerid, banInfo->steamid }, Plugin_Milliseconds());
+        return verdict ? kickBanned(m_admission.slotOf(banInfo->playerid), *verdict) : plugpp::NoKick;
     }
 
     /// Gets called when the @ref plugpp::onPlayerGetBanStatus() function returns @ref plugpp::NoKick and the
@@ -172,22 +576,41 @@ public:
     ///
     /// @param client The client joining the server.
     virtual void onPlayerAccessGranted(client_t* client) final override {
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_ACCESS_GRANTED);
+        const int slot = Plugin_GetClientNumForClient(client);
+        m_admission.grant(slot);
         io::println("Player {} with player ID {} joined the server",
-                    plugpp::removeColor(client->name),
+                    m_names.name(slot),
                     client->playerid);
     }
 
     /// Gets called before level fast restart (map fast restart)
-    virtual void onPreFastRestart() final override { io::println("The map is about to get reloaded"); }
+    virtual void onPreFastRestart() final override {
+        EXAMPLE_PROFILE_HOOK(ON_PRE_FAST_RESTART);
+        io::println("The map is about to get reloaded");
+    }
 
     /// Gets called after level fast restart (map fast restart)
-    virtual void onPostFastRestart() final override { io::println("Map reloaded"); }
+    virtual void onPostFastRestart() final override {
+        EXAMPLE_PROFILE_HOOK(ON_POST_FAST_RESTART);
+        io::println("Map reloaded");
+    }
 
     /// Gets called at the end of a level (end of map)
-    virtual void onExitLevel() final override { io::println("Map ended"); }
+    virtual void onExitLevel() final override {
+        EXAMPLE_PROFILE_HOOK(ON_EXIT_LEVEL);
+        m_trace.event(trace::RecordType::EXIT_LEVEL);
+        m_queryCache.invalidate();
+        rollOverMatch();
+        io::println("Map ended");
+    }
 
     /// Gets called at the beginning of a level (beginning of a map)
     virtual void onSpawnServer() final override {
+        EXAMPLE_PROFILE_HOOK(ON_SPAWN_SERVER);
+        m_trace.event(trace::RecordType::SPAWN_SERVER);
+        m_queryCache.invalidate();
+        rollOverMatch();
         char mapname[256];
         Plugin_Cvar_VariableStringBuffer("mapname", mapname, sizeof(mapname));
         io::println("Map {} loeded", mapname);
@@ -195,17 +618,81 @@ public:
 
     /// Gets called every server frame (sv_fps times per second, usually 20 Hz)
     virtual void onFrame() final override {
-        static constexpr size_t ONE_SECOND = 20; // 20 Hz
-        static std::size_t i = 0;
-        if (++i % (10 * ONE_SECOND) == 0) {
-            io::println("10 second timer");
+        {
+            // The frame is ended outside of the hook's scope, so the hook is charged to the frame it ran in
+            EXAMPLE_PROFILE_HOOK(ON_FRAME);
+            m_clock.tick();
+            m_telemetry.frames.add();
+            m_scheduler.advance(m_clock.now(), static_cast<std::size_t>(m_tasksPerFrame.get()));
+
+            const int now = Plugin_Milliseconds();
+            const int frameInterval = now - m_telemetry.lastFrameAt;
+            if (m_telemetry.lastFrameAt != 0 && frameInterval >= 0) {
+                m_telemetry.frameIntervals.observe(static_cast<std::uint64_t>(frameInterval));
+            }
+            m_telemetry.lastFrameAt = now;
+            m_bans.poll(now);
+            m_admission.setLimits({ m_admissionInflight.get(),
+                                    m_admissionPerFrame.get(),
+                                    m_admissionMaxWait.get(),
+                                    m_admissionVerdictTtl.get() });
+            m_admission.advance(now);
+
+            m_floodLimiter.setTime(now);
+            m_floodLimiter.setLimit(net::PacketClass::QUERY, { m_udpQueryRate.get(), m_udpQueryBurst.get() });
+            m_floodLimiter.setLimit(net::PacketClass::CONNECT,
+                                    { m_udpConnectRate.get(), m_udpConnectBurst.get() });
+            m_floodLimiter.setLimit(net::PacketClass::OTHER, { m_udpOtherRate.get(), m_udpOtherBurst.get() });
+            m_floodLimiter.setReplyLimit({ m_udpReplyRate.get(), m_udpReplyBurst.get() });
+            m_queryCache.setTtl(m_queryCacheTtl.get());
+
+            if (const bool tracing = m_traceEnabled.get() != 0; tracing != m_trace.enabled()) {
+                m_trace.setEnabled(tracing, m_tracePath.get());
+            }
+            m_trace.flush(now);
+
+            m_moves.analyze(static_cast<std::uint32_t>(m_moveWindowsPerFrame.get()));
+            m_moves.takeAlerts([](const int slot,
+                                  const std::uint8_t alerts,
+                                  const anticheat::MoveStats& stats) {
+                EXAMPLE_LOG_RATE_LIMITED(info,
+                                         20,
+                                         10 * 1000,
+                                         "Suspicious move commands from slot {}:{}{}{} (max angle change {}, "
+                                         "interval jitter {:.1f} ms)",
+                                         slot,
+                                         alerts & anticheat::MoveAnalyzer::SPIKE ? " spikes" : "",
+                                         alerts & anticheat::MoveAnalyzer::SNAP ? " snaps" : "",
+                                         alerts & anticheat::MoveAnalyzer::TIMING ? " timing" : "",
+                                         stats.maxDelta,
+                                         stats.jitter);
+            });
+
+            m_screenshots.poll([this](const screenshot::Result& result) { onScreenshotProcessed(result); });
+
+            const auto overflowPolicy = static_cast<io::OverflowPolicy>(m_printOverflowPolicy.get());
+            io::consoleQueue().setOverflowPolicy(overflowPolicy);
+            io::consoleQueue().drain(m_printBytesPerFrame.get(), m_printLinesPerFrame.get());
         }
+#ifdef PLUGPP_EXAMPLE_PROFILING
+        const std::uint64_t budgetNs = static_cast<std::uint64_t>(m_frameBudget.get()) * 1000;
+        if (const std::uint64_t frameNs = perf::profiler().endFrame(budgetNs); frameNs > budgetNs) {
+            EXAMPLE_LOG_RATE_LIMITED(debug,
+                                     10,
+                                     10 * 1000,
+                                     "Frame {} went over the budget, the plugin took {} us",
+                                     m_clock.frames(),
+                                     frameNs / 1000);
+        }
+#endif
     }
 
     /// Gets called when a player spawns
     /// @param entity The entity corresponding to the player.
     virtual void onClientSpawn(gentity_t* entity) final override {
+        EXAMPLE_PROFILE_HOOK(ON_CLIENT_SPAWN);
         if (entity && entity->client) {
+            m_trace.event(trace::RecordType::SPAWN, entity->client->ps.clientNum);
             io::println("Client in slot {} spawned", entity->client->ps.clientNum);
         }
     }
@@ -219,6 +706,8 @@ public:
     /// @param firstTime true if this was the first time the player has entered the world over the period of
     /// the player being connected to the server, false otherwise.
     virtual void onClientEnteredWorld(client_t* client, bool firstTime) final override {
+        EXAMPLE_PROFILE_HOOK(ON_CLIENT_ENTERED_WORLD);
+        m_trace.event(trace::RecordType::ENTER_WORLD, Plugin_GetClientNumForClient(client));
         if (firstTime) {
             Plugin_ChatPrintf(Plugin_GetClientNumForClient(client), "^2Welcome, %s^2!", client->name);
         }
@@ -231,16 +720,40 @@ public:
     ///
     /// @param client The player whose userinfo has changed.
     virtual void onClientUserInfoChanged(client_t* client) final override {
-        io::println(
-            "Players userinfo has changed for {}: {}", plugpp::removeColor(client->name), client->userinfo);
+        EXAMPLE_PROFILE_HOOK(ON_CLIENT_USER_INFO_CHANGED);
+        const int slot = Plugin_GetClientNumForClient(client);
+        m_trace.event(trace::RecordType::USERINFO, slot);
+        const userinfo::Changes& changes = m_userinfo.update(slot, client->userinfo);
+        if (changes.empty()) {
+            return;
+        }
+        m_queryCache.invalidate(); // The name shows in the player list of getstatus
+        updateName(slot);
+
+        fmt::memory_buffer text;
+        for (const userinfo::Change& change : changes) {
+            fmt::format_to(
+                std::back_inserter(text), " {} '{}' -> '{}'", change.name, change.oldValue, change.newValue);
+        }
+        io::println("Players userinfo has changed for {}:{}", m_names.name(slot), fmt::to_string(text));
+
+        if (std::string reason = checkRates(changes); !reason.empty()) {
+            // Drop the client outside of the engine's userinfo update, a disconnect cancels it
+            m_scheduler.schedule(
+                0, [slot, reason] { Plugin_DropClient(static_cast<unsigned>(slot), reason.c_str()); }, slot);
+        }
     }
 
     /// Gets called whenever a client sends a move command
     /// @param client The client who sent the move command.
     /// @param ucmd The move command.
     virtual void onClientMoveCommand(client_t* client, usercmd_t* ucmd) final override {
-        (void)client;
-        (void)ucmd;
+        EXAMPLE_PROFILE_HOOK(ON_CLIENT_MOVE_COMMAND);
+        const int slot = Plugin_GetClientNumForClient(client);
+        m_moves.record(slot, *ucmd);
+        if (m_trace.enabled()) {
+            m_trace.move(slot, *ucmd);
+        }
     }
 
     /// Gets called when a player gets killed
@@ -259,21 +772,9 @@ public:
                                 int meansOfDeath,
                                 int iWeapon,
                                 hitLocation_t hitLocation) final override {
-        static constexpr std::string_view MEANS_OF_DEATH_NAMES[] = {
-            "MOD_UNKNOWN",        "MOD_PISTOL_BULLET", "MOD_RIFLE_BULLET",      "MOD_GRENADE",
-            "MOD_GRENADE_SPLASH", "MOD_PROJECTILE",    "MOD_PROJECTILE_SPLASH", "MOD_MELEE",
-            "MOD_HEAD_SHOT",      "MOD_CRUSH",         "MOD_TELEFRAG",          "MOD_FALLING",
-            "MOD_SUICIDE",        "MOD_TRIGGER_HURT",  "MOD_EXPLOSIVE",         "MOD_IMPACT",
-        };
-
-        static constexpr std::string_view HITLOC_NAMES[] = {
-            "HITLOC_NONE",      "HITLOC_HELMET",    "HITLOC_HEAD",      "HITLOC_NECK",
-            "HITLOC_TORSO_UPR", "HITLOC_TORSO_LWR", "HITLOC_R_ARM_UPR", "HITLOC_L_ARM_UPR",
-            "HITLOC_R_ARM_LWR", "HITLOC_L_ARM_LWR", "HITLOC_R_HAND",    "HITLOC_L_HAND",
-            "HITLOC_R_LEG_UPR", "HITLOC_L_LEG_UPR", "HITLOC_R_LEG_LWR", "HITLOC_L_LEG_LWR",
-            "HITLOC_R_FOOT",    "HITLOC_L_FOOT",    "HITLOC_GUN",       "HITLOC_NUM",
-        };
-
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_KILLED);
+        m_queryCache.invalidate(); // The scores changed
+        m_telemetry.kill(meansOfDeath);
         static auto getClientNum = [](gentity_s* entity) -> plugpp::Optional<int> {
             if (entity && entity->client) {
                 return entity->client->ps.clientNum;
@@ -281,14 +782,30 @@ public:
             return plugpp::NullOptional;
         };
 
+        const auto victimSlot = getClientNum(self);
+        const auto attackerSlot = getClientNum(attacker);
+        if (victimSlot) {
+            m_matchStats.kill(
+                attackerSlot ? *attackerSlot : -1, *victimSlot, iWeapon, meansOfDeath, hitLocation);
+        }
+        if (m_trace.enabled()) {
+            // Slots are below 64, the world (or no entity) is recorded as 255
+            m_trace.kill(victimSlot ? *victimSlot : 255,
+                         attackerSlot ? *attackerSlot : 255,
+                         iWeapon,
+                         meansOfDeath,
+                         hitLocation,
+                         damage);
+        }
+
         io::println("self {}; inflictor {}; attacker {}; damage {}; meansOfDeath {}; iWeapon {}; hitLoc {}",
                     getClientNum(self),
                     getClientNum(inflictor),
                     getClientNum(attacker),
                     damage,
-                    MEANS_OF_DEATH_NAMES[meansOfDeath],
+                    stats::MEANS_OF_DEATH_NAMES[meansOfDeath],
                     BG_WeaponName(iWeapon),
-                    HITLOC_NAMES[hitLocation]);
+                    stats::HITLOC_NAMES[hitLocation]);
     }
 
     /// Gets called when a player requests joining to a reserved (password protected) slot
@@ -296,10 +813,9 @@ public:
     /// @returns plugpp::ReservedSlotRequest::ALLOW to allow the player to join or
     /// plugpp::ReservedSlotRequest::DENY to deny the request.
     virtual plugpp::ReservedSlotRequest onPlayerReservedSlotRequest(netadr_t* from) final override {
-        return from->type == netadrtype_t::NA_IP && from->ip[0] == 12 && from->ip[1] == 34 &&
-                       from->ip[2] == 56 && from->ip[3] == 78
-                   ? plugpp::ReservedSlotRequest::ALLOW
-                   : plugpp::ReservedSlotRequest::DENY;
+        EXAMPLE_PROFILE_HOOK(ON_PLAYER_RESERVED_SLOT_REQUEST);
+        return m_ipPolicy.lookup(*from) == net::IpAction::RESERVED ? plugpp::ReservedSlotRequest::ALLOW
+                                                                   : plugpp::ReservedSlotRequest::DENY;
     }
 
     /// Gets called when a `usercall` function gets called from a GSC script.
@@ -312,7 +828,14 @@ public:
     ///
     /// @param functionName The function name supplied to the `usercall` GSC function call.
     virtual void onScrUsercallFunction(const std::string& functionName) final override {
-        io::println("A usercall '{}' was issued from a GSC script", functionName);
+        EXAMPLE_PROFILE_HOOK(ON_SCR_USERCALL_FUNCTION);
+        static constexpr auto FUNCTIONS = gsc::makeFunctions<ExamplePlugin>(
+            gsc::usercall<&ExamplePlugin::scrPrint>("example_print"),
+            gsc::usercall<&ExamplePlugin::scrLeaderboard>("example_leaderboard"));
+        if (!FUNCTIONS.call(*this, functionName)) {
+            EXAMPLE_LOG_EVERY_N(
+                debug, 1000, "An unknown usercall '{}' was issued from a GSC script", functionName);
+        }
     }
 
     /// Gets called when a `usercall` method gets called from a GSC script.
@@ -326,18 +849,29 @@ public:
     /// @param functionName The function name supplied to the `usercall` GSC method call.
     /// @param slot The slot of the player this function was called for.
     virtual void onScrUsercallMethod(const std::string& methodName, int slot) final override {
-        auto client = plugpp::getClientBySlot(slot);
-        if (!client) {
+        EXAMPLE_PROFILE_HOOK(ON_SCR_USERCALL_METHOD);
+        static constexpr auto METHODS = gsc::makeMethods<ExamplePlugin>(
+            gsc::usercall<&ExamplePlugin::scrUserinfo>("example_userinfo"),
+            gsc::usercall<&ExamplePlugin::scrMoveAlerts>("example_move_alerts"),
+            gsc::usercall<&ExamplePlugin::scrRank>("example_rank"),
+            gsc::usercall<&ExamplePlugin::scrStat>("example_stat"),
+            gsc::usercall<&ExamplePlugin::scrKillDeathRatio>("example_kd_ratio"),
+            gsc::usercall<&ExamplePlugin::scrHeadshotPercent>("example_headshot_percent"));
+        if (slot < 0 || slot >= userinfo::UserinfoCache::SLOTS) {
             return;
         }
-        client_t* cl = *client;
-        io::println("A usercall '{}' was issued for player {} from a GSC script",
-                    methodName,
-                    plugpp::removeColor(cl->name));
+        if (!METHODS.call(*this, methodName, slot)) {
+            EXAMPLE_LOG_EVERY_N(debug,
+                                1000,
+                                "An unknown usercall '{}' was issued for slot {} from a GSC script",
+                                methodName,
+                                slot);
+        }
     }
 
     /// This function is currently never called
     virtual void onModuleLoaded(client_t* client, const std::string& fullpath, long checksum) final override {
+        EXAMPLE_PROFILE_HOOK(ON_MODULE_LOADED);
         (void)client;
         (void)fullpath;
         (void)checksum;
@@ -347,7 +881,11 @@ public:
     /// @param client The client captured in the arrived screenshot.
     /// @param path The path to the screenshot.
     virtual void onScreenshotArrived(client_t* client, const std::string& path) final override {
-        io::println("Screenshot '{}' arrived for player {}", path, plugpp::removeColor(client->name));
+        EXAMPLE_PROFILE_HOOK(ON_SCREENSHOT_ARRIVED);
+        const int slot = Plugin_GetClientNumForClient(client);
+        io::println("Screenshot '{}' arrived for player {}", path, m_names.name(slot));
+        m_screenshots.setStoreDirectory(m_screenshotStore.get());
+        m_screenshots.submit(slot, client->playerid, path);
     }
 
     /// Gets called whenever there is a UDP packet event on the network
@@ -359,10 +897,22 @@ public:
     /// @param size The size of the received data.
     /// @returns true if the packet should be dropped, false otherwise.
     virtual bool onUdpNetEvent(netadr_t* from, void* data, int size) final override {
-        (void)from;
-        (void)data;
-        (void)size;
-        return false;
+        EXAMPLE_PROFILE_HOOK(ON_UDP_NET_EVENT);
+        const net::PacketClass packetClass = net::FloodLimiter::classify(data, size);
+        // Packets of established connections are never looked up, the denied clients got kicked on connect
+        const bool denied =
+            packetClass != net::PacketClass::IN_GAME && m_ipPolicy.lookup(*from) == net::IpAction::DENY;
+        bool drop = denied || !m_floodLimiter.allow(*from, packetClass);
+        if (!drop && packetClass == net::PacketClass::QUERY) {
+            drop = !m_floodLimiter.mayReply(*from) || replyFromCache(*from, data, size);
+        }
+        m_trace.udpIn(*from, size, static_cast<int>(packetClass), drop);
+        m_telemetry.udpPacketsIn.add();
+        m_telemetry.udpBytesIn.add(static_cast<std::uint64_t>(std::max(size, 0)));
+        if (drop) {
+            m_telemetry.udpDropped.add();
+        }
+        return drop;
     }
 
     /// Gets called whenever a UDP packet is sent from the server
@@ -374,11 +924,400 @@ public:
     /// @param len The size of the transmitted data.
     /// @returns true if the packet should be dropped, false otherwise.
     virtual bool onUdpSend(netadr_t* to, void* data, int len) final override {
-        (void)to;
-        (void)data;
-        (void)len;
+        EXAMPLE_PROFILE_HOOK(ON_UDP_SEND);
+        m_trace.udpOut(len);
+        m_telemetry.udpPacketsOut.add();
+        m_telemetry.udpBytesOut.add(static_cast<std::uint64_t>(std::max(len, 0)));
+        if (m_replyingFromCache) {
+            return false; // Charged by replyFromCache()
+        }
+        if (net::FloodLimiter::classify(data, len) != net::PacketClass::IN_GAME) {
+            m_floodLimiter.chargeReply(*to, len);
+            m_queryCache.learn(data, len, Plugin_Milliseconds());
+        }
         return false;
     }
+
+private:
+    /// Answers a getinfo/getstatus query with the cached reply of the engine
+    /// @returns true if the query got answered and shall be dropped.
+    bool replyFromCache(netadr_t& from, const void* data, const int size) {
+        net::Query query;
+        if (!net::QueryCache::parse(data, size, query)) {
+            return false;
+        }
+        const std::string_view reply = m_queryCache.respond(query, Plugin_Milliseconds());
+        if (reply.empty()) {
+            return false;
+        }
+        const int length = static_cast<int>(reply.size());
+        m_replyingFromCache = true;
+        Plugin_NET_SendPacket(NS_SERVER, length, reply.data(), &from);
+        m_replyingFromCache = false;
+        m_floodLimiter.chargeReply(from, length);
+        return true;
+    }
+
+    /// Acts on a screenshot processed by the @ref screenshot::ScreenshotPipeline
+    void onScreenshotProcessed(const screenshot::Result& result) {
+        if (!result.error.empty()) {
+            EXAMPLE_LOG_RATE_LIMITED(
+                warn, 10, 10 * 1000, "Can't process the screenshot '{}': {}", result.path, result.error);
+            return;
+        }
+        if (result.flags == 0) {
+            return;
+        }
+        // The player may have left while the screenshot was processed
+        client_t* client = Plugin_GetClientForClientNum(result.slot);
+        const bool present = client && client->state >= CS_CONNECTED && client->playerid == result.playerid;
+        spdlog::warn("Flagged the screenshot '{}' of player ID {}{}:{}",
+                     result.path,
+                     result.playerid,
+                     present ? fmt::format(" in slot {}", result.slot) : std::string(" who already left"),
+                     describeFlags(result.flags));
+    }
+
+    static std::string describeFlags(const std::uint8_t flags) {
+        std::string text;
+        for (const auto& [flag, name] : { std::pair(screenshot::MALFORMED, " malformed"),
+                                          std::pair(screenshot::BLANK, " blank"),
+                                          std::pair(screenshot::REPEATED, " repeated"),
+                                          std::pair(screenshot::FOREIGN, " sent by another player") }) {
+            if (flags & flag) {
+                text += name;
+            }
+        }
+        return text;
+    }
+
+#ifdef PLUGPP_EXAMPLE_PROFILING
+    /// Writes the latency percentiles of every hook which has been called, line by line
+    template <typename Writer>
+    static void writeProfile(Writer&& write) {
+        const auto& profiler = perf::profiler();
+        static constexpr auto toUs = [](const std::uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+        write(fmt::format(
+            "{:<28} {:>10} {:>10} {:>10} {:>10}", "hook", "calls", "p50 us", "p99 us", "max us"));
+        for (std::size_t i = 0; i < static_cast<std::size_t>(perf::Hook::COUNT); ++i) {
+            const auto& histogram = profiler.hook(static_cast<perf::Hook>(i));
+            if (histogram.count() == 0) {
+                continue;
+            }
+            write(fmt::format("{:<28} {:>10} {:>10.1f} {:>10.1f} {:>10.1f}",
+                              perf::HOOK_NAMES[i],
+                              histogram.count(),
+                              toUs(histogram.percentile(0.5)),
+                              toUs(histogram.percentile(0.99)),
+                              toUs(histogram.max())));
+        }
+        const auto& frames = profiler.frames();
+        write(fmt::format("plugin time per frame: p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us, {} of {} "
+                          "frames over budget",
+                          toUs(frames.percentile(0.5)),
+                          toUs(frames.percentile(0.99)),
+                          toUs(frames.max()),
+                          profiler.overBudget(),
+                          frames.count()));
+    }
+
+#endif
+    /// Updates the sampled gauges and hands the cvars over to the exporter, runs every second
+    void sampleMetrics() {
+        m_telemetry.players.set(static_cast<std::int64_t>(m_matchStats.leaderboard().size()));
+        m_telemetry.screenshotsPending.set(static_cast<std::int64_t>(m_screenshots.pending()));
+        m_telemetry.handshakesInflight.set(m_admission.inflight());
+        m_telemetry.handshakesWaiting.set(m_admission.waiting());
+        m_metricsExporter.configure(m_metricsTarget.get(), m_metricsInterval.get());
+    }
+
+    /// Caches the name of the slot's userinfo and warns about a name passing for another player's one
+    void updateName(const int slot) {
+        if (!m_names.update(slot, m_userinfo.get(slot).get(userinfo::Key::NAME))) {
+            return;
+        }
+        if (const int other = m_names.findClash(slot); other >= 0) {
+            EXAMPLE_LOG_RATE_LIMITED(warn,
+                                     10,
+                                     10 * 1000,
+                                     "Player {} in slot {} {} player {} in slot {}",
+                                     m_names.name(slot),
+                                     slot,
+                                     m_names.name(slot) == m_names.name(other) ? "has the same name as"
+                                                                               : "may be impersonating",
+                                     m_names.name(other),
+                                     other);
+        }
+    }
+
+    /// Checks the rate and the snaps among the changed keys of a userinfo
+    /// @returns The reason to drop the client for or an empty string.
+    std::string checkRates(const userinfo::Changes& changes) const {
+        for (const userinfo::Change& change : changes) {
+            if (change.type == userinfo::ChangeType::REMOVED) {
+                continue;
+            }
+            const int value = userinfo::Userinfo::toInt(change.newValue).value_or(0);
+            if (change.key == userinfo::Key::RATE && value < m_minRate.get()) {
+                return fmt::format("Set your rate to at least {}", m_minRate.get());
+            }
+            if (change.key == userinfo::Key::SNAPS && value < m_minSnaps.get()) {
+                return fmt::format("Set your snaps to at least {}", m_minSnaps.get());
+            }
+        }
+        return {};
+    }
+
+    /// `usercall("example_print", message)` prints the message into the console
+    void scrPrint(const std::string_view message) { io::println("{}", message); }
+
+    /// `player usercall("example_userinfo", key)` returns the value of the key in the player's userinfo
+    std::string_view scrUserinfo(const int slot, const std::string_view key) {
+        const userinfo::Userinfo& info = m_userinfo.get(slot);
+        const std::size_t i = info.find(key);
+        return i == userinfo::Userinfo::NPOS ? std::string_view() : info.value(i);
+    }
+
+    /// `player usercall("example_move_alerts")` returns the number of suspicious view angle changes
+    int scrMoveAlerts(const int slot) {
+        const anticheat::MoveStats& stats = m_moves.stats(slot);
+        return static_cast<int>(stats.spikes + stats.snaps);
+    }
+
+    /// `usercall("example_leaderboard", rank)` returns the slot of the player at the 0-based rank of the
+    /// match, or -1 past the last player
+    int scrLeaderboard(const int rank) {
+        return rank < 0 ? -1 : m_matchStats.leaderboard().at(static_cast<std::size_t>(rank));
+    }
+
+    /// `player usercall("example_rank")` returns the player's 0-based rank in the match
+    int scrRank(const int slot) { return m_matchStats.leaderboard().rank(slot); }
+
+    /// `player usercall("example_stat", name)` returns the kills, deaths, headshots or suicides of the player
+    /// in the match, or the kills by a hit location given by its name, e.g., "HITLOC_HEAD"
+    int scrStat(const int slot, const std::string_view name) {
+        const stats::MatchStats::State& s = m_matchStats.state();
+        for (const auto& [statName, counters] : { std::pair("kills", s.kills),
+                                                  std::pair("deaths", s.deaths),
+                                                  std::pair("headshots", s.headshots),
+                                                  std::pair("suicides", s.suicides) }) {
+            if (name == statName) {
+                return static_cast<int>(counters[slot]);
+            }
+        }
+        for (std::size_t i = 0; i < stats::MatchStats::HITLOCS; ++i) {
+            if (name == stats::HITLOC_NAMES[i]) {
+                return static_cast<int>(s.hitLocations[slot][i]);
+            }
+        }
+        Plugin_Scr_Error("example_stat: expected kills, deaths, headshots, suicides or a HITLOC_ name");
+        return 0;
+    }
+
+    /// `player usercall("example_kd_ratio")` returns the player's kills per death in the match
+    float scrKillDeathRatio(const int slot) { return m_matchStats.killDeathRatio(slot); }
+
+    /// `player usercall("example_headshot_percent")` returns the percentage of the player's kills which were
+    /// headshots
+    float scrHeadshotPercent(const int slot) { return m_matchStats.headshotPercent(slot); }
+
+    /// Writes the summary of the match if anybody died in it and starts the next one
+    void rollOverMatch() {
+        const stats::MatchStats::State& s = m_matchStats.state();
+        const int now = Plugin_Milliseconds();
+        if (const std::string directory = m_matchSummaries.get(); s.events > 0 && !directory.empty()) {
+            auto summary = std::make_shared<stats::MatchSummary>();
+            summary->stats = s;
+            summary->endedAt = std::time(nullptr);
+            summary->durationMs = now - s.startedAt;
+            for (int slot = 0; slot < static_cast<int>(stats::MatchStats::SLOTS); ++slot) {
+                const client_t* client =
+                    s.leaderboard.contains(slot) ? Plugin_GetClientForClientNum(slot) : nullptr;
+                if (client && client->state >= CS_CONNECTED) {
+                    summary->names[slot] = m_names.name(slot);
+                    summary->playerids[slot] = client->playerid;
+                }
+                for (std::size_t weapon = 0; weapon < stats::MatchStats::WEAPONS; ++weapon) {
+                    if (s.weaponKills[slot][weapon] != 0 && summary->weaponNames.size() <= weapon) {
+                        summary->weaponNames.resize(weapon + 1);
+                    }
+                    if (s.weaponKills[slot][weapon] != 0 && summary->weaponNames[weapon].empty()) {
+                        summary->weaponNames[weapon] = BG_WeaponName(static_cast<int>(weapon));
+                    }
+                }
+            }
+            m_matchSummaryWriter.write(directory, std::move(summary));
+        }
+        char mapname[64];
+        Plugin_Cvar_VariableStringBuffer("mapname", mapname, sizeof(mapname));
+        m_matchStats.start(mapname, now);
+    }
+
+    /// Hands the caches, the per-client data and the counters over to the next instance of the plugin
+    ///
+    /// Scheduled tasks and pending ban lookups aren't carried over, the next instance creates its own.
+    void saveState() const {
+        state::StateWriter writer(m_restored.generation() + 1);
+        m_floodLimiter.save(writer);
+        m_moves.save(writer);
+        m_userinfo.save(writer);
+        m_bans.save(writer, Plugin_Milliseconds());
+        m_matchStats.save(writer);
+        writer.publish();
+    }
+
+    /// Kicks the client of the slot if the verdict is a ban, the kick is remembered by the admission
+    plugpp::Kick kickBanned(const int slot, const ban::Verdict& verdict) {
+        if (!verdict.banned || (verdict.expire != 0 && verdict.expire <= std::time(nullptr))) {
+            return plugpp::NoKick;
+        }
+        std::string message = verdict.expire == 0
+                                  ? fmt::format("You are permanently banned: {}", verdict.reason)
+                                  : fmt::format("You are banned until {:%Y-%m-%d %H:%M} UTC: {}",
+                                                fmt::gmtime(static_cast<std::time_t>(verdict.expire)),
+                                                verdict.reason);
+        m_telemetry.kicksBanned.add();
+        m_admission.reject(slot, message, verdict.expire);
+        return plugpp::Kick(std::move(message));
+    }
+
+    /// Metrics updated by the callbacks
+    struct Telemetry {
+        static constexpr const char* ADMISSIONS_HELP = "Authentication requests by the admission outcome";
+
+        explicit Telemetry(metrics::Registry& registry)
+            : connects(registry.counter("example_connects_total", "Clients connecting to the server"))
+            , kicksIpPolicy(registry.counter(
+                  "example_kicks_total", "Connecting clients kicked by the plugin", R"(reason="ip_policy")"))
+            , kicksRates(registry.counter(
+                  "example_kicks_total", "Connecting clients kicked by the plugin", R"(reason="rates")"))
+            , kicksBanned(registry.counter(
+                  "example_kicks_total", "Connecting clients kicked by the plugin", R"(reason="banned")"))
+            , chatShown(
+                  registry.counter("example_chat_messages_total", "Chat messages", R"(visibility="shown")"))
+            , chatHidden(
+                  registry.counter("example_chat_messages_total", "Chat messages", R"(visibility="hidden")"))
+            , udpPacketsIn(
+                  registry.counter("example_udp_packets_total", "UDP packets", R"(direction="in")"))
+            , udpPacketsOut(
+                  registry.counter("example_udp_packets_total", "UDP packets", R"(direction="out")"))
+            , udpBytesIn(
+                  registry.counter("example_udp_bytes_total", "UDP payload bytes", R"(direction="in")"))
+            , udpBytesOut(
+                  registry.counter("example_udp_bytes_total", "UDP payload bytes", R"(direction="out")"))
+            , udpDropped(registry.counter("example_udp_dropped_total", "Received UDP packets dropped"))
+            , frames(registry.counter("example_frames_total", "Server frames"))
+            , frameIntervals(registry.histogram("example_frame_interval_seconds",
+                                                "Time between the server frames",
+                                                { 25, 50, 75, 100, 150, 250, 500, 1000, 5000 },
+                                                1e-3))
+            , players(registry.gauge("example_players", "Players in the game"))
+            , screenshotsPending(
+                  registry.gauge("example_screenshots_pending", "Screenshots waiting to be processed"))
+            , admissionsStarted(
+                  registry.counter("example_admissions_total", ADMISSIONS_HELP, R"(result="started")"))
+            , admissionsDeferred(
+                  registry.counter("example_admissions_total", ADMISSIONS_HELP, R"(result="deferred")"))
+            , admissionsRejected(
+                  registry.counter("example_admissions_total", ADMISSIONS_HELP, R"(result="rejected")"))
+            , admissionWaits(registry.histogram("example_admission_wait_seconds",
+                                                "Time the clients waited for the admission",
+                                                { 0, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000 },
+                                                1e-3))
+            , handshakesInflight(
+                  registry.gauge("example_handshakes_inflight", "Connection handshakes in progress"))
+            , handshakesWaiting(
+                  registry.gauge("example_handshakes_waiting", "Clients waiting for the admission")) {
+            for (std::size_t mod = 0; mod < std::size(kills); ++mod) {
+                kills[mod] = &registry.counter("example_kills_total",
+                                               "Deaths by the means of death",
+                                               fmt::format(R"(mod="{}")", stats::MEANS_OF_DEATH_NAMES[mod]));
+            }
+        }
+
+        void kill(const int meansOfDeath) {
+            const bool known = meansOfDeath >= 0 && static_cast<std::size_t>(meansOfDeath) < std::size(kills);
+            kills[known ? meansOfDeath : 0]->add();
+        }
+
+        metrics::Counter& connects;
+        metrics::Counter& kicksIpPolicy;
+        metrics::Counter& kicksRates;
+        metrics::Counter& kicksBanned;
+        metrics::Counter& chatShown;
+        metrics::Counter& chatHidden;
+        metrics::Counter& udpPacketsIn;
+        metrics::Counter& udpPacketsOut;
+        metrics::Counter& udpBytesIn;
+        metrics::Counter& udpBytesOut;
+        metrics::Counter& udpDropped;
+        metrics::Counter& frames;
+        metrics::Histogram& frameIntervals; ///< In milliseconds.
+        metrics::Gauge& players;
+        metrics::Gauge& screenshotsPending;
+        metrics::Counter& admissionsStarted;
+        metrics::Counter& admissionsDeferred;
+        metrics::Counter& admissionsRejected;
+        metrics::Histogram& admissionWaits; ///< In milliseconds.
+        metrics::Gauge& handshakesInflight;
+        metrics::Gauge& handshakesWaiting;
+        metrics::Counter* kills[std::size(stats::MEANS_OF_DEATH_NAMES)];
+        int lastFrameAt = 0;
+    };
+
+    state::StateSnapshot m_restored; ///< Declared first so it outlives everything adopted from it.
+    console::IntCvar m_printLinesPerFrame;
+    console::IntCvar m_printBytesPerFrame;
+    console::IntCvar m_printOverflowPolicy;
+    console::StringCvar m_banStorePath;
+    console::IntCvar m_banLookupTimeout;
+    ban::BanService m_bans;
+    console::StringCvar m_chatWordList;
+    chat::ChatFilter m_chatFilter;
+    console::StringCvar m_ipPolicyPath;
+    net::IpPolicy m_ipPolicy;
+    console::IntCvar m_udpQueryRate;
+    console::IntCvar m_udpQueryBurst;
+    console::IntCvar m_udpConnectRate;
+    console::IntCvar m_udpConnectBurst;
+    console::IntCvar m_udpOtherRate;
+    console::IntCvar m_udpOtherBurst;
+    console::IntCvar m_udpReplyRate;
+    console::IntCvar m_udpReplyBurst;
+    console::IntCvar m_queryCacheTtl;
+    net::FloodLimiter m_floodLimiter;
+    net::QueryCache m_queryCache;
+    bool m_replyingFromCache = false; ///< Set while the engine sends a reply of the cache.
+    console::IntCvar m_tasksPerFrame;
+    sched::FrameClock m_clock;
+    sched::Scheduler m_scheduler;
+    console::IntCvar m_traceEnabled;
+    console::StringCvar m_tracePath;
+    trace::TraceRecorder m_trace;
+    console::IntCvar m_moveWindowsPerFrame;
+    anticheat::MoveAnalyzer m_moves;
+    console::IntCvar m_minRate;
+    console::IntCvar m_minSnaps;
+    userinfo::UserinfoCache m_userinfo;
+    console::StringCvar m_screenshotStore;
+    screenshot::ScreenshotPipeline m_screenshots;
+    stats::MatchStats m_matchStats;
+    console::StringCvar m_matchSummaries;
+    stats::MatchSummaryWriter m_matchSummaryWriter;
+    names::NameCache m_names;
+    metrics::Registry m_metrics;
+    Telemetry m_telemetry;
+    console::StringCvar m_metricsTarget;
+    console::IntCvar m_metricsInterval;
+    metrics::MetricsExporter m_metricsExporter;
+    console::IntCvar m_admissionInflight;
+    console::IntCvar m_admissionPerFrame;
+    console::IntCvar m_admissionMaxWait;
+    console::IntCvar m_admissionVerdictTtl;
+    admission::AdmissionController m_admission;
+#ifdef PLUGPP_EXAMPLE_PROFILING
+    console::IntCvar m_frameBudget;
+#endif
 };
 
 } // namespace example
@@ -0,0 +1,294 @@
+#ifndef PLUGPP_EXAMPLE_ADMISSION_ADMISSIONCONTROLLER_H
+#define PLUGPP_EXAMPLE_ADMISSION_ADMISSIONCONTROLLER_H
+
+#include "plugpp-example/perf/Histogram.h"
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace example::admission {
+
+/// Limits of the admission, all of them 0 to disable the limit
+struct Limits {
+    int inflight;   ///< Handshakes in progress at a time.
+    int perFrame;   ///< Handshakes started per server frame.
+    int maxWaitMs;  ///< Wait after which a client is let in regardless of the in-flight limit.
+    int verdictTtl; ///< Milliseconds the outcome of a handshake is reused for.
+};
+
+enum class Action : std::uint8_t {
+    ADMIT,  ///< Go on with the handshake
+    DEFER,  ///< Ask again with the client's next authentication request
+    REJECT, ///< Kick the client for the reason the previous handshake ended with
+};
+
+struct Decision {
+    Action action;
+    std::string_view reason; ///< Kick message of a rejected client.
+    bool started;            ///< The handshake got admitted by this request.
+    int waitedMs;            ///< Time the client waited for the admission.
+};
+
+/// Admission control of the connecting clients, e.g., when everybody reconnects after a map change
+///
+/// A handshake is in flight from the moment a client gets admitted in @ref admit() until it gets access or
+/// leaves. Clients over the limits are deferred - they keep resending their authentication requests and get
+/// admitted in the order they first asked, the priority clients (reserved slots, players returning with the
+/// same IP address and player ID) as if they asked @ref PRIORITY_HEAD_START_MS earlier. A client waiting for
+/// longer than the maximum wait is admitted over the in-flight limit (but not the per-frame one), so joining
+/// takes little longer than that. The outcome of a finished handshake is remembered per (IP address, player
+/// ID), which makes the player a returning one, or rejects them again right away if they got kicked.
+///
+/// Shall only be used from the game thread.
+class AdmissionController {
+public:
+    static constexpr int SLOTS = 64;
+    static constexpr int PRIORITY_HEAD_START_MS = 5000;
+    static constexpr int HANDSHAKE_TIMEOUT_MS = 30 * 1000; ///< Handshakes not finished by then are dropped.
+    static constexpr int WAITER_TIMEOUT_MS = 5000;         ///< Deferred clients which stopped asking.
+    static constexpr std::size_t VERDICT_CAPACITY = 4096; ///< Remembered outcomes, the oldest are evicted.
+
+    struct Stats {
+        std::uint64_t admitted;
+        std::uint64_t prioritized;
+        std::uint64_t deferred; ///< Authentication requests answered with a deferral.
+        std::uint64_t overdue;  ///< Admitted after the maximum wait, possibly over the in-flight limit.
+        std::uint64_t rejected; ///< Rejected by a remembered verdict.
+        std::uint64_t timedOut; ///< Handshakes and waits dropped without an outcome.
+    };
+
+    void setLimits(const Limits& limits) { m_limits = limits; }
+
+    /// Starts the next server frame
+    /// @param now The current time in milliseconds.
+    void advance(const int now) {
+        m_now = now;
+        m_admittedThisFrame = 0;
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            Slot& s = m_slots[slot];
+            const bool stale = (s.state == State::INFLIGHT && now - s.since >= HANDSHAKE_TIMEOUT_MS) ||
+                               (s.state == State::WAITING && now - s.lastSeen >= WAITER_TIMEOUT_MS);
+            if (stale) {
+                ++m_stats.timedOut;
+                release(slot);
+            }
+        }
+        if (now - m_lastPrune >= 1000) {
+            m_lastPrune = now;
+            for (auto it = m_verdicts.begin(); it != m_verdicts.end();) {
+                it = now - it->second.expiresAt >= 0 ? m_verdicts.erase(it) : std::next(it);
+            }
+        }
+    }
+
+    /// Decides whether the client may go on with the handshake, asked on every authentication request
+    /// @param reserved The client connects from an address with reserved slots.
+    Decision admit(const int slot, const netadr_t& from, const std::uint64_t playerid, const bool reserved) {
+        if (slot < 0 || slot >= SLOTS) {
+            return { Action::ADMIT, {}, false, 0 };
+        }
+        Slot& s = m_slots[slot];
+        if (s.state == State::INFLIGHT) {
+            return { Action::ADMIT, {}, false, 0 }; // Asking again while e.g. a ban lookup is pending
+        }
+        const Key key = makeKey(from, playerid);
+        bool returning = false;
+        if (auto it = m_verdicts.find(key); it != m_verdicts.end() && m_now - it->second.expiresAt < 0) {
+            if (!it->second.allowed) {
+                ++m_stats.rejected;
+                release(slot);
+                return { Action::REJECT, it->second.reason, false, 0 };
+            }
+            returning = true;
+        }
+
+        if (s.state == State::FREE) {
+            s.state = State::WAITING;
+            s.since = m_now;
+            s.priority = reserved || returning;
+        }
+        s.lastSeen = m_now;
+        s.key = key;
+
+        // The overdue clients skip the line, but not the per-frame limit keeping the frame time flat
+        const bool overdue = m_limits.maxWaitMs > 0 && m_now - s.since >= m_limits.maxWaitMs;
+        const bool frameFull = m_limits.perFrame > 0 && m_admittedThisFrame >= m_limits.perFrame;
+        if (frameFull || (!overdue && !fits(slot))) {
+            ++m_stats.deferred;
+            return { Action::DEFER, {}, false, 0 };
+        }
+        m_stats.overdue += overdue ? 1 : 0;
+        m_stats.prioritized += s.priority ? 1 : 0;
+        ++m_stats.admitted;
+        ++m_admittedThisFrame;
+        ++m_inflight;
+        const int waited = m_now - s.since;
+        m_waits.record(static_cast<std::uint64_t>(waited) * 1000 * 1000);
+        s.state = State::INFLIGHT;
+        s.since = m_now;
+        return { Action::ADMIT, {}, true, waited };
+    }
+
+    /// Ends the handshake of a client who got access, the player is a returning one from now on
+    void grant(const int slot) { finish(slot, true, {}, m_limits.verdictTtl); }
+
+    /// Ends the handshake of a kicked client, who gets rejected for the same reason for a while
+    /// @param until Unix time in seconds the reason stops applying at, e.g., when a ban expires, 0 if never.
+    void reject(const int slot, const std::string_view reason, const std::int64_t until = 0) {
+        int ttl = m_limits.verdictTtl;
+        if (until != 0) {
+            const std::int64_t left = (until - static_cast<std::int64_t>(std::time(nullptr))) * 1000;
+            ttl = static_cast<int>(std::clamp<std::int64_t>(left, 0, ttl));
+        }
+        finish(slot, false, reason, ttl);
+    }
+
+    /// Forgets the client of the slot without remembering an outcome, e.g., when the client disconnects
+    void release(const int slot) {
+        if (slot < 0 || slot >= SLOTS) {
+            return;
+        }
+        Slot& s = m_slots[slot];
+        m_inflight -= s.state == State::INFLIGHT ? 1 : 0;
+        s.state = State::FREE;
+    }
+
+    /// Forgets the outcomes of the player's handshakes, e.g., when the player gets banned or unbanned
+    void forget(const std::uint64_t playerid) {
+        for (auto it = m_verdicts.begin(); it != m_verdicts.end();) {
+            it = it->first.playerid == playerid ? m_verdicts.erase(it) : std::next(it);
+        }
+    }
+
+    /// Returns the slot of the player's handshake in flight or -1 if there's none
+    int slotOf(const std::uint64_t playerid) const {
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            if (m_slots[slot].state == State::INFLIGHT && m_slots[slot].key.playerid == playerid) {
+                return slot;
+            }
+        }
+        return -1;
+    }
+
+    int inflight() const { return m_inflight; }
+
+    int waiting() const {
+        return static_cast<int>(std::count_if(
+            std::begin(m_slots), std::end(m_slots), [](const Slot& s) { return s.state == State::WAITING; }));
+    }
+
+    const Stats& stats() const { return m_stats; }
+
+    /// Time the admitted clients waited for the admission, in nanoseconds
+    const perf::Histogram& waits() const { return m_waits; }
+
+private:
+    enum class State : std::uint8_t { FREE, WAITING, INFLIGHT };
+
+    struct Key {
+        std::uint64_t address[2];
+        std::uint64_t playerid;
+        std::uint8_t type;
+
+        bool operator==(const Key& other) const {
+            return address[0] == other.address[0] && address[1] == other.address[1] &&
+                   playerid == other.playerid && type == other.type;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            std::uint64_t h = key.address[0] ^ (key.address[1] * 0x9E3779B97F4A7C15ULL) ^ key.type;
+            h = (h ^ key.playerid) * 0xFF51AFD7ED558CCDULL;
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        }
+    };
+
+    struct Verdict {
+        bool allowed;
+        std::string reason;
+        int expiresAt;
+    };
+
+    struct Slot {
+        State state;
+        bool priority;
+        int since; ///< When the client started waiting or got admitted.
+        int lastSeen;
+        Key key;
+    };
+
+    static Key makeKey(const netadr_t& address, const std::uint64_t playerid) {
+        Key key{};
+        if (address.type == NA_IP6) {
+            std::memcpy(key.address, address.ip6, sizeof(address.ip6));
+        } else {
+            std::memcpy(key.address, address.ip, sizeof(address.ip));
+        }
+        key.playerid = playerid;
+        key.type = static_cast<std::uint8_t>(address.type);
+        return key;
+    }
+
+    /// Returns true if the waiting client is within the in-flight limit, counting the clients ahead of it
+    bool fits(const int slot) const {
+        if (m_limits.inflight <= 0) {
+            return true;
+        }
+        const int turn = turnOf(m_slots[slot]);
+        int ahead = 0;
+        for (int other = 0; other < SLOTS; ++other) {
+            const Slot& o = m_slots[other];
+            if (other != slot && o.state == State::WAITING &&
+                (turnOf(o) < turn || (turnOf(o) == turn && other < slot))) {
+                ++ahead;
+            }
+        }
+        return m_inflight + ahead < m_limits.inflight;
+    }
+
+    static int turnOf(const Slot& s) { return s.since - (s.priority ? PRIORITY_HEAD_START_MS : 0); }
+
+    void finish(const int slot, const bool allowed, const std::string_view reason, const int ttl) {
+        if (slot < 0 || slot >= SLOTS || m_slots[slot].state == State::FREE) {
+            return;
+        }
+        if (ttl > 0) {
+            const Key& key = m_slots[slot].key;
+            if (m_verdicts.size() >= VERDICT_CAPACITY && m_verdicts.count(key) == 0) {
+                // Makes room by evicting the verdict closest to expiring, only ever scanned when full
+                const auto soonest = [](const auto& a, const auto& b) {
+                    return a.second.expiresAt - b.second.expiresAt < 0;
+                };
+                m_verdicts.erase(std::min_element(m_verdicts.begin(), m_verdicts.end(), soonest));
+            }
+            Verdict& verdict = m_verdicts[key];
+            verdict.allowed = allowed;
+            verdict.reason.assign(reason.data(), reason.size());
+            verdict.expiresAt = m_now + ttl;
+        }
+        release(slot);
+    }
+
+    Limits m_limits{};
+    int m_now = 0;
+    int m_lastPrune = 0;
+    int m_inflight = 0;
+    int m_admittedThisFrame = 0;
+    Slot m_slots[SLOTS] = {};
+    std::unordered_map<Key, Verdict, KeyHash> m_verdicts;
+    Stats m_stats{};
+    perf::Histogram m_waits;
+};
+
+} // namespace example::admission
+
+#endif // PLUGPP_EXAMPLE_ADMISSION_ADMISSIONCONTROLLER_H
@@ -0,0 +1,227 @@
+#ifndef PLUGPP_EXAMPLE_ANTICHEAT_MOVEANALYZER_H
+#define PLUGPP_EXAMPLE_ANTICHEAT_MOVEANALYZER_H
+
+#include "plugpp-example/anticheat/MoveKernels.h"
+#include "plugpp-example/state/StateSnapshot.h"
+#include "plugpp-example/state/StateWriter.h"
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace example::anticheat {
+
+/// Statistics of the move commands of a client
+struct MoveStats {
+    std::uint64_t commands;
+    std::uint64_t windows;
+    std::uint64_t skipped;      ///< Commands overwritten before they were analyzed.
+    std::uint64_t spikes;
+    std::uint64_t snaps;
+    std::uint64_t nonMonotonic;
+    std::int32_t maxDelta;      ///< Largest view angle change seen, in short angle units.
+    float meanInterval;         ///< Moving average of the command interval in milliseconds.
+    float jitter;               ///< Moving average of the standard deviation of the interval.
+};
+
+/// Collects the move commands of every client and analyzes them in windows
+///
+/// Recording a command only stores it into the client's ring buffer. The analysis runs separately, from
+/// @ref analyze() called once per server frame with a budget, so the cost per command is constant and the
+/// analysis can't stall a frame. Nothing allocates after the construction.
+class MoveAnalyzer {
+public:
+    static constexpr std::uint32_t SLOTS = 64;
+    static constexpr std::uint32_t LENGTH = 128; ///< Commands kept per client, a multiple of @ref WINDOW.
+    static_assert(LENGTH % WINDOW == 0 && (LENGTH & (LENGTH - 1)) == 0);
+
+    /// Bits of @ref State::alerts
+    enum Alert : std::uint8_t {
+        SPIKE = 1,
+        SNAP = 2,
+        TIMING = 4,
+    };
+
+    /// Ring buffers of all the clients as structure of arrays, followed by the analysis state
+    ///
+    /// The whole state is trivially copyable.
+    struct State {
+        alignas(64) std::int32_t serverTime[SLOTS][LENGTH];
+        alignas(64) std::int32_t buttons[SLOTS][LENGTH];
+        alignas(64) std::int16_t pitch[SLOTS][LENGTH];
+        alignas(64) std::int16_t yaw[SLOTS][LENGTH];
+        std::uint32_t head[SLOTS];     ///< Number of commands recorded.
+        std::uint32_t analyzed[SLOTS]; ///< Number of commands analyzed.
+        WindowCarry carry[SLOTS];
+        MoveStats stats[SLOTS];
+        std::uint8_t alerts[SLOTS]; ///< @ref Alert bits raised since the last @ref takeAlerts().
+        std::uint32_t cursor;       ///< Slot the next @ref analyze() starts with.
+    };
+    static_assert(std::is_trivially_copyable_v<State>);
+
+    /// Layout version of @ref State, shall be bumped whenever the structure changes
+    static constexpr std::uint32_t STATE_VERSION = 1;
+
+    void setThresholds(const Thresholds& thresholds) { m_thresholds = thresholds; }
+
+    /// Stores the command into the client's ring buffer
+    void record(const int slot, const usercmd_t& cmd) {
+        if (slot < 0 || static_cast<std::uint32_t>(slot) >= SLOTS) {
+            return;
+        }
+        State& s = *m_state;
+        const std::uint32_t index = s.head[slot] & (LENGTH - 1);
+        s.serverTime[slot][index] = cmd.serverTime;
+        s.buttons[slot][index] = cmd.buttons;
+        s.pitch[slot][index] = static_cast<std::int16_t>(cmd.angles[0]);
+        s.yaw[slot][index] = static_cast<std::int16_t>(cmd.angles[1]);
+        ++s.head[slot];
+    }
+
+    /// Forgets the commands and the statistics of the client, e.g., when the slot gets free
+    void reset(const int slot) {
+        if (slot < 0 || static_cast<std::uint32_t>(slot) >= SLOTS) {
+            return;
+        }
+        State& s = *m_state;
+        s.head[slot] = 0;
+        s.analyzed[slot] = 0;
+        s.carry[slot] = {};
+        s.stats[slot] = {};
+        s.alerts[slot] = 0;
+    }
+
+    /// Analyzes the complete windows of recorded commands, visiting the clients round-robin
+    /// @param budget The maximum number of windows to analyze.
+    /// @returns The number of windows analyzed.
+    std::uint32_t analyze(const std::uint32_t budget) {
+        State& s = *m_state;
+        std::uint32_t done = 0;
+        std::uint32_t idle = 0;
+        while (done < budget && idle < SLOTS) {
+            const std::uint32_t slot = s.cursor;
+            s.cursor = (s.cursor + 1) % SLOTS;
+            if (s.head[slot] - s.analyzed[slot] < WINDOW + 1) {
+                ++idle;
+                continue;
+            }
+            idle = 0;
+            analyzeWindow(slot);
+            ++done;
+        }
+        return done;
+    }
+
+    const MoveStats& stats(const int slot) const { return m_state->stats[slot]; }
+
+    /// Calls the function with every slot which raised an alert since the last call, and clears the alerts
+    template <typename Fn>
+    void takeAlerts(Fn&& fn) {
+        State& s = *m_state;
+        for (std::uint32_t slot = 0; slot < SLOTS; ++slot) {
+            if (s.alerts[slot]) {
+                fn(static_cast<int>(slot), s.alerts[slot], s.stats[slot]);
+                s.alerts[slot] = 0;
+            }
+        }
+    }
+
+    /// Stores the commands and the statistics for the next instance of the plugin
+    void save(state::StateWriter& writer) const {
+        writer.addPod(state::SectionId::MOVE_ANALYZER, STATE_VERSION, *m_state);
+        state::RecordWriter records;
+        for (std::uint32_t slot = 0; slot < SLOTS; ++slot) {
+            if (m_state->stats[slot].windows != 0) {
+                records.add(slot, m_state->stats[slot]);
+            }
+        }
+        writer.addRecords(state::SectionId::MOVE_ANALYZER, RECORDS_VERSION, records);
+    }
+
+    /// Continues with the state of the previous instance of the plugin
+    ///
+    /// The state is used in place when its layout didn't change, otherwise only the statistics are restored
+    /// and the analysis starts over with the next commands.
+    void restore(state::StateSnapshot& snapshot) {
+        if (State* state = snapshot.adopt<State>(state::SectionId::MOVE_ANALYZER, STATE_VERSION)) {
+            m_state.adopt(*state);
+            return;
+        }
+        snapshot.forEachRecord(
+            state::SectionId::MOVE_ANALYZER, RECORDS_VERSION, [this](const state::Record& record) {
+                if (record.tag < SLOTS) {
+                    record.read(m_state->stats[record.tag]);
+                }
+            });
+    }
+
+private:
+    /// Version of the records written by @ref save(), one @ref MoveStats per slot tagged with the slot
+    static constexpr std::uint32_t RECORDS_VERSION = 1;
+
+    /// Weight of a new window in the moving averages
+    static constexpr float SMOOTHING = 1.0f / 16.0f;
+    /// Standard deviation of the command interval in milliseconds which is reported
+    static constexpr float JITTER_ALERT = 8.0f;
+
+    void analyzeWindow(const std::uint32_t slot) {
+        State& s = *m_state;
+        MoveStats& stats = s.stats[slot];
+
+        // The window starts right after the last analyzed command, which is kept as its predecessor. If the
+        // client got too far ahead, the overwritten commands are skipped.
+        std::uint32_t first = s.analyzed[slot];
+        if (s.head[slot] - first > LENGTH) {
+            const std::uint32_t skipTo = s.head[slot] - LENGTH;
+            stats.skipped += skipTo - first;
+            first = skipTo;
+            s.carry[slot] = {};
+        }
+
+        // Copy the window out of the ring so the kernel reads contiguous arrays even across the wrap-around
+        alignas(16) std::int16_t pitch[WINDOW + 1];
+        alignas(16) std::int16_t yaw[WINDOW + 1];
+        alignas(16) std::int32_t serverTime[WINDOW + 1];
+        for (std::uint32_t i = 0; i <= WINDOW; ++i) {
+            const std::uint32_t index = (first + i) & (LENGTH - 1);
+            pitch[i] = s.pitch[slot][index];
+            yaw[i] = s.yaw[slot][index];
+            serverTime[i] = s.serverTime[slot][index];
+        }
+        s.analyzed[slot] = first + WINDOW;
+
+        const WindowResult result =
+            anticheat::analyzeWindow(pitch, yaw, serverTime, m_thresholds, s.carry[slot]);
+
+        stats.commands = s.head[slot];
+        ++stats.windows;
+        stats.spikes += static_cast<std::uint64_t>(result.spikes);
+        stats.snaps += static_cast<std::uint64_t>(result.snaps);
+        stats.nonMonotonic += static_cast<std::uint64_t>(result.nonMonotonic);
+        stats.maxDelta = std::max(stats.maxDelta, result.maxDelta);
+
+        const float mean = static_cast<float>(result.intervalSum) / WINDOW;
+        const float variance = std::max(0.0f, static_cast<float>(result.intervalSqr) / WINDOW - mean * mean);
+        const float deviation = std::sqrt(variance);
+        if (stats.windows == 1) {
+            stats.meanInterval = mean;
+            stats.jitter = deviation;
+        } else {
+            stats.meanInterval += (mean - stats.meanInterval) * SMOOTHING;
+            stats.jitter += (deviation - stats.jitter) * SMOOTHING;
+        }
+
+        s.alerts[slot] |= (result.spikes > 0 ? SPIKE : 0) | (result.snaps > 0 ? SNAP : 0) |
+                          (result.nonMonotonic > 0 || stats.jitter > JITTER_ALERT ? TIMING : 0);
+    }
+
+    state::StatePtr<State> m_state;
+    Thresholds m_thresholds;
+};
+
+} // namespace example::anticheat
+
+#endif // PLUGPP_EXAMPLE_ANTICHEAT_MOVEANALYZER_H
@@ -0,0 +1,155 @@
+#ifndef PLUGPP_EXAMPLE_ANTICHEAT_MOVEKERNELS_H
+#define PLUGPP_EXAMPLE_ANTICHEAT_MOVEKERNELS_H
+
+#include <cstdint>
+#include <cstring>
+
+/// Vectorized analysis of windows of move commands
+///
+/// The kernels are written with GCC's generic vector extensions rather than intrinsics - the plugin is built
+/// for 32-bit x86 where SSE2 isn't guaranteed, the compiler lowers the vectors to SSE2 when it's enabled and
+/// to scalar code otherwise. Angles are processed as 16-bit lanes (the engine's short angles), so the
+/// wrap-around of the subtraction yields the shortest signed angle difference for free.
+///
+/// This header has no dependencies on the server's API.
+namespace example::anticheat {
+
+/// Number of commands analyzed at once
+constexpr std::uint32_t WINDOW = 16;
+
+/// Angle thresholds in the engine's short angle units (65536 per full turn)
+struct Thresholds {
+    std::int16_t spike = 8192; ///< 45 degrees between two commands.
+    std::int16_t snap = 3641;  ///< 20 degrees in one command...
+    std::int16_t settle = 91;  ///< ...surrounded by commands turning less than 0.5 degrees.
+};
+
+/// Result of a single window
+struct WindowResult {
+    std::int32_t maxDelta;     ///< Largest view angle change between two commands.
+    std::int32_t spikes;       ///< Changes above @ref Thresholds::spike.
+    std::int32_t snaps;        ///< Flicks - a large change between two still commands.
+    std::int32_t intervalSum;  ///< Sum of the serverTime differences in milliseconds.
+    std::int32_t intervalSqr;  ///< Sum of their squares.
+    std::int32_t nonMonotonic; ///< Commands whose serverTime didn't advance.
+};
+
+/// Carried over from one window of a client to the next one
+struct WindowCarry {
+    std::int16_t magnitude[2]; ///< The last two angle changes of the previous window.
+};
+
+namespace detail {
+
+    using v8hi = std::int16_t __attribute__((vector_size(16)));
+    using v4si = std::int32_t __attribute__((vector_size(16)));
+
+    template <typename V, typename T>
+    inline V load(const T* data) {
+        V v;
+        std::memcpy(&v, data, sizeof(v));
+        return v;
+    }
+
+    template <typename V>
+    inline V select(const V mask, const V a, const V b) {
+        return (a & mask) | (b & ~mask);
+    }
+
+    /// Saturating absolute value, the lowest value (a half turn) maps to the highest one
+    template <typename V>
+    inline V abs(const V v) {
+        const V sign = v >> (sizeof(v[0]) * 8 - 1);
+        const V result = (v ^ sign) - sign;
+        return result + (result < V{}); // Lanes of a true comparison are -1
+    }
+
+    template <typename V>
+    inline std::int32_t sum(const V v) {
+        std::int32_t total = 0;
+        for (std::size_t i = 0; i < sizeof(V) / sizeof(v[0]); ++i) {
+            total += v[i];
+        }
+        return total;
+    }
+
+    template <typename V>
+    inline std::int32_t max(const V v) {
+        std::int32_t result = v[0];
+        for (std::size_t i = 1; i < sizeof(V) / sizeof(v[0]); ++i) {
+            result = v[i] > result ? v[i] : result;
+        }
+        return result;
+    }
+
+} // namespace detail
+
+/// Analyzes a window of @ref WINDOW commands
+///
+/// Every input array holds the command preceding the window followed by the commands of the window, so it's
+/// WINDOW + 1 elements long.
+inline WindowResult analyzeWindow(const std::int16_t* pitch,
+                                  const std::int16_t* yaw,
+                                  const std::int32_t* serverTime,
+                                  const Thresholds& thresholds,
+                                  WindowCarry& carry) {
+    using namespace detail;
+    constexpr std::uint32_t LANES16 = sizeof(v8hi) / sizeof(std::int16_t);
+    constexpr std::uint32_t LANES32 = sizeof(v4si) / sizeof(std::int32_t);
+
+    // View angle change between consecutive commands, the larger of the pitch and the yaw change
+    alignas(16) std::int16_t magnitudes[WINDOW + 2];
+    magnitudes[0] = carry.magnitude[0];
+    magnitudes[1] = carry.magnitude[1];
+    v8hi maxDelta{};
+    v8hi spikes{};
+    const v8hi spike = v8hi{} + thresholds.spike;
+    for (std::uint32_t i = 0; i < WINDOW; i += LANES16) {
+        const v8hi pitchDelta = abs(load<v8hi>(pitch + i + 1) - load<v8hi>(pitch + i));
+        const v8hi yawDelta = abs(load<v8hi>(yaw + i + 1) - load<v8hi>(yaw + i));
+        const v8hi magnitude = select(pitchDelta > yawDelta, pitchDelta, yawDelta);
+        std::memcpy(magnitudes + 2 + i, &magnitude, sizeof(magnitude));
+        maxDelta = select(magnitude > maxDelta, magnitude, maxDelta);
+        spikes -= magnitude > spike; // Lanes of a true comparison are -1
+    }
+
+    // Snaps centred on the last change of the previous window up to the second to last one of this window
+    v8hi snaps{};
+    const v8hi snap = v8hi{} + thresholds.snap;
+    const v8hi settle = v8hi{} + thresholds.settle;
+    for (std::uint32_t i = 0; i < WINDOW; i += LANES16) {
+        const v8hi before = load<v8hi>(magnitudes + i);
+        const v8hi centre = load<v8hi>(magnitudes + i + 1);
+        const v8hi after = load<v8hi>(magnitudes + i + 2);
+        snaps -= (centre >= snap) & (before <= settle) & (after <= settle);
+    }
+    carry.magnitude[0] = magnitudes[WINDOW];
+    carry.magnitude[1] = magnitudes[WINDOW + 1];
+
+    // Intervals between the commands, clamped so the sums can't overflow
+    v4si intervalSum{};
+    v4si intervalSqr{};
+    v4si nonMonotonic{};
+    const v4si low = v4si{} - 1000;
+    const v4si high = v4si{} + 1000;
+    for (std::uint32_t i = 0; i < WINDOW; i += LANES32) {
+        v4si interval = load<v4si>(serverTime + i + 1) - load<v4si>(serverTime + i);
+        interval = select(interval < low, low, select(interval > high, high, interval));
+        intervalSum += interval;
+        intervalSqr += interval * interval;
+        nonMonotonic -= interval <= v4si{};
+    }
+
+    WindowResult result;
+    result.maxDelta = max(maxDelta);
+    result.spikes = sum(spikes);
+    result.snaps = sum(snaps);
+    result.intervalSum = sum(intervalSum);
+    result.intervalSqr = sum(intervalSqr);
+    result.nonMonotonic = sum(nonMonotonic);
+    return result;
+}
+
+} // namespace example::anticheat
+
+#endif // PLUGPP_EXAMPLE_ANTICHEAT_MOVEKERNELS_H
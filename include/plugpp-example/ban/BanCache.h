@@ -0,0 +1,134 @@
+#ifndef PLUGPP_EXAMPLE_BAN_BANCACHE_H
+#define PLUGPP_EXAMPLE_BAN_BANCACHE_H
+
+#include <cod4-plugpp/Plugin.hpp>
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace example::ban {
+
+/// Answer of a ban lookup
+struct Verdict {
+    bool banned;
+    std::string reason;
+    std::int64_t expire; ///< Unix time when the ban expires, 0 for permanent bans.
+};
+
+/// Identity of a player as presented during authentication
+struct PlayerKey {
+    std::uint64_t playerid;
+    std::uint64_t steamid;
+
+    bool operator==(const PlayerKey& other) const {
+        return playerid == other.playerid && steamid == other.steamid;
+    }
+};
+
+struct PlayerKeyHash {
+    std::size_t operator()(const PlayerKey& key) const {
+        return std::hash<std::uint64_t>{}(key.playerid * 0x9E3779B97F4A7C15ULL ^ key.steamid);
+    }
+};
+
+/// Least-recently-used cache of ban verdicts with a time-to-live
+///
+/// Shall only be accessed from the game thread. Every entry remembers the sequence number of the request it
+/// was produced by, so an answer for a request issued before a more recent write-through can't overwrite it.
+class BanCache {
+public:
+    explicit BanCache(const std::size_t capacity)
+        : m_capacity(capacity) {
+        m_index.reserve(capacity);
+    }
+
+    /// Looks up a verdict which is still valid at the given time, a temporary ban which has expired is a miss
+    /// @param now The current time in milliseconds.
+    const Verdict* find(const PlayerKey& key, const int now) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            return nullptr;
+        }
+        const Verdict& verdict = it->second->verdict;
+        const bool lifted = verdict.banned && verdict.expire != 0 && verdict.expire <= std::time(nullptr);
+        if (now - it->second->expiresAt >= 0 || lifted) {
+            m_entries.erase(it->second);
+            m_index.erase(it);
+            return nullptr;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return &it->second->verdict;
+    }
+
+    /// Inserts or updates the verdict unless the cache already holds a more recent one
+    /// @param ttl Time-to-live of the verdict in milliseconds.
+    /// @param now The current time in milliseconds.
+    /// @param sequence Sequence number of the request the verdict was produced by.
+    void insert(const PlayerKey& key,
+                Verdict verdict,
+                const int ttl,
+                const int now,
+                const std::uint64_t sequence) {
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            if (it->second->sequence > sequence) {
+                return;
+            }
+            it->second->verdict = std::move(verdict);
+            it->second->expiresAt = now + ttl;
+            it->second->sequence = sequence;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
+        }
+        if (m_entries.size() >= m_capacity) {
+            m_index.erase(m_entries.back().key);
+            m_entries.pop_back();
+        }
+        m_entries.push_front(Entry{ key, std::move(verdict), now + ttl, sequence });
+        m_index.emplace(key, m_entries.begin());
+    }
+
+    /// Drops all the entries matching either of the IDs
+    void invalidate(const std::uint64_t playerid, const std::uint64_t steamid) {
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            const bool matches = (playerid != 0 && it->key.playerid == playerid) ||
+                                 (steamid != 0 && it->key.steamid == steamid);
+            if (matches) {
+                m_index.erase(it->key);
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::size_t size() const { return m_entries.size(); }
+
+    /// Calls the function with every entry, the least recently used one first
+    /// @param fn Called with the key, the verdict, the expiry time in milliseconds and the sequence number.
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+            fn(it->key, it->verdict, it->expiresAt, it->sequence);
+        }
+    }
+
+private:
+    struct Entry {
+        PlayerKey key;
+        Verdict verdict;
+        int expiresAt;
+        std::uint64_t sequence;
+    };
+
+    const std::size_t m_capacity;
+    std::list<Entry> m_entries;
+    std::unordered_map<PlayerKey, std::list<Entry>::iterator, PlayerKeyHash> m_index;
+};
+
+} // namespace example::ban
+
+#endif // PLUGPP_EXAMPLE_BAN_BANCACHE_H
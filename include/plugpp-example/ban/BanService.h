@@ -0,0 +1,284 @@
+#ifndef PLUGPP_EXAMPLE_BAN_BANSERVICE_H
+#define PLUGPP_EXAMPLE_BAN_BANSERVICE_H
+
+#include "plugpp-example/ban/BanCache.h"
+#include "plugpp-example/ban/BanStore.h"
+#include "plugpp-example/io/log.h"
+#include "plugpp-example/state/StateSnapshot.h"
+#include "plugpp-example/state/StateWriter.h"
+#include "plugpp-example/util/WorkerPool.h"
+
+#include <cod4-plugpp/Plugin.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace example::ban {
+
+/// Non-blocking ban lookups backed by the @ref BanStore
+///
+/// All the public functions shall be called from the game thread. A lookup which misses the cache is handed
+/// over to the worker pool and reported as pending - the caller is expected to ask again later (e.g., using
+/// the `returnNow` mechanism of @ref plugpp::Plugin::onPlayerGotAuthInfo()). Answers are collected by
+/// @ref poll(). Concurrent lookups for the same player are merged into a single request. Bans and unbans
+/// are stored by a single writer thread in the order they were made in, so the last one always wins.
+class BanService {
+public:
+    struct Settings {
+        std::string path;
+        std::size_t workers;
+        std::size_t queueCapacity;
+        std::size_t cacheCapacity;
+        int positiveTtl; ///< Milliseconds a ban stays cached.
+        int negativeTtl; ///< Milliseconds a "not banned" answer stays cached.
+    };
+
+    explicit BanService(Settings settings)
+        : m_settings(std::move(settings))
+        , m_store(std::make_shared<BanStore>(m_settings.path))
+        , m_cache(m_settings.cacheCapacity)
+        , m_workers(m_settings.workers, m_settings.queueCapacity)
+        , m_writer(1, m_settings.queueCapacity) {}
+
+    BanService(const BanService&) = delete;
+    BanService& operator=(const BanService&) = delete;
+
+    /// Waits for room for the records still queued on the game thread, the writer stores them on its way out
+    ~BanService() noexcept {
+        while (!flushWrites()) {
+            std::this_thread::yield();
+        }
+    }
+
+    /// Returns the verdict for the player or NullOptional if it's not known yet
+    ///
+    /// @param now The current time in milliseconds.
+    plugpp::Optional<Verdict> lookup(const PlayerKey& key, const int now) {
+        poll(now);
+        if (const Verdict* verdict = m_cache.find(key, now)) {
+            return *verdict;
+        }
+        // The first request is remembered even when the queue is full, so the lookup can time out
+        Pending& pending = m_pending.try_emplace(key, Pending{ now, now, false }).first->second;
+        pending.lastAsked = now;
+        if (!pending.posted) {
+            const std::uint64_t sequence = ++m_sequence;
+            pending.posted = m_workers.tryPost([this, store = m_store, key, sequence] {
+                auto record = store->find(key.playerid, key.steamid);
+                std::lock_guard lock(m_resultsMutex);
+                m_results.push_back(Result{ key, sequence, std::move(record) });
+            });
+        }
+        return plugpp::NullOptional;
+    }
+
+    /// Returns the number of milliseconds the lookup for the player has been pending for
+    int pendingFor(const PlayerKey& key, const int now) const {
+        auto it = m_pending.find(key);
+        return it == m_pending.end() ? 0 : now - it->second.since;
+    }
+
+    /// Moves the answers of finished lookups into the cache
+    /// @param now The current time in milliseconds.
+    void poll(const int now) {
+        {
+            std::lock_guard lock(m_resultsMutex);
+            m_completed.swap(m_results);
+        }
+        for (auto& result : m_completed) {
+            m_pending.erase(result.key);
+            if (const auto& record = result.record) {
+                m_cache.insert(result.key,
+                               Verdict{ true, std::string(record->getReason()), record->expire },
+                               positiveTtl(record->expire),
+                               now,
+                               result.sequence);
+            } else {
+                m_cache.insert(
+                    result.key, Verdict{ false, {}, 0 }, m_settings.negativeTtl, now, result.sequence);
+            }
+        }
+        m_completed.clear();
+        flushWrites();
+        // Lookups never posted are only answered by asking again, drop the ones of the clients who left
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            const bool abandoned = !it->second.posted && now - it->second.lastAsked >= ABANDONED_LOOKUP_MS;
+            it = abandoned ? m_pending.erase(it) : std::next(it);
+        }
+    }
+
+    /// Writes the ban through the cache into the store
+    ///
+    /// @param duration Duration of the ban in seconds, 0 for a permanent ban.
+    /// @param now The current time in milliseconds.
+    void addBan(const PlayerKey& key, const std::string& reason, const int duration, const int now) {
+        BanRecord record{};
+        record.playerid = key.playerid;
+        record.steamid = key.steamid;
+        record.expire = duration > 0 ? std::time(nullptr) + duration : 0;
+        record.flags = BanRecord::ACTIVE;
+        record.setReason(reason);
+        m_cache.invalidate(key.playerid, key.steamid);
+        m_cache.insert(
+            key, Verdict{ true, reason, record.expire }, positiveTtl(record.expire), now, ++m_sequence);
+        write(record);
+    }
+
+    /// Writes the removal of the ban through the cache into the store
+    /// @param now The current time in milliseconds.
+    void removeBan(const PlayerKey& key, const int now) {
+        BanRecord record{};
+        record.playerid = key.playerid;
+        record.steamid = key.steamid;
+        m_cache.invalidate(key.playerid, key.steamid);
+        m_cache.insert(key, Verdict{ false, {}, 0 }, m_settings.negativeTtl, now, ++m_sequence);
+        write(record);
+    }
+
+    /// Stores the cached verdicts for the next instance of the plugin
+    ///
+    /// Lookups still in progress are dropped, they're simply issued again.
+    /// @param now The current time in milliseconds.
+    void save(state::StateWriter& writer, const int now) const {
+        state::RecordWriter records;
+        records.add(SEQUENCE_RECORD, m_sequence);
+        std::string buffer;
+        m_cache.forEach([&](const PlayerKey& key, const Verdict& verdict, const int expiresAt,
+                            const std::uint64_t sequence) {
+            if (expiresAt - now <= 0) {
+                return;
+            }
+            const CachedVerdict cached{ key.playerid, key.steamid, verdict.expire, sequence, expiresAt,
+                                        verdict.banned };
+            buffer.assign(reinterpret_cast<const char*>(&cached), sizeof(cached));
+            buffer += verdict.reason;
+            records.add(VERDICT_RECORD, buffer.data(), buffer.size());
+        });
+        writer.addRecords(state::SectionId::BAN_CACHE, RECORDS_VERSION, records);
+    }
+
+    /// Fills the cache with the verdicts of the previous instance of the plugin, so the players don't have
+    /// to be looked up again
+    /// @param now The current time in milliseconds.
+    void restore(state::StateSnapshot& snapshot, const int now) {
+        snapshot.forEachRecord(
+            state::SectionId::BAN_CACHE, RECORDS_VERSION, [this, now](const state::Record& record) {
+                if (record.tag == SEQUENCE_RECORD) {
+                    std::uint64_t sequence = 0;
+                    record.read(sequence);
+                    m_sequence = std::max(m_sequence, sequence);
+                    return;
+                }
+                CachedVerdict cached;
+                if (record.tag != VERDICT_RECORD || record.size < sizeof(cached)) {
+                    return;
+                }
+                std::memcpy(&cached, record.data, sizeof(cached));
+                m_sequence = std::max(m_sequence, cached.sequence);
+                if (cached.expiresAt - now > 0) {
+                    std::string reason(static_cast<const char*>(record.data) + sizeof(cached),
+                                       record.size - sizeof(cached));
+                    m_cache.insert({ cached.playerid, cached.steamid },
+                                   Verdict{ cached.banned, std::move(reason), cached.expire },
+                                   cached.expiresAt - now,
+                                   now,
+                                   cached.sequence);
+                }
+            });
+    }
+
+private:
+    /// Version of the records written by @ref save()
+    static constexpr std::uint32_t RECORDS_VERSION = 1;
+
+    enum : std::uint32_t {
+        SEQUENCE_RECORD = 1, ///< The last sequence number
+        VERDICT_RECORD,      ///< CachedVerdict followed by the reason
+    };
+
+    struct CachedVerdict {
+        std::uint64_t playerid;
+        std::uint64_t steamid;
+        std::int64_t expire;
+        std::uint64_t sequence;
+        std::int32_t expiresAt;
+        bool banned;
+    };
+
+    struct Result {
+        PlayerKey key;
+        std::uint64_t sequence;
+        plugpp::Optional<BanRecord> record;
+    };
+
+    struct Pending {
+        int since; ///< When the player was first looked up.
+        int lastAsked;
+        bool posted; ///< Handed over to the worker pool, false while the queue was full.
+    };
+
+    static constexpr int ABANDONED_LOOKUP_MS = 60 * 1000;
+
+    /// Returns how long a ban stays cached, no longer than until it expires
+    int positiveTtl(const std::int64_t expire) const {
+        if (expire == 0) {
+            return m_settings.positiveTtl;
+        }
+        const std::int64_t left = (expire - static_cast<std::int64_t>(std::time(nullptr))) * 1000;
+        return static_cast<int>(std::clamp<std::int64_t>(left, 0, m_settings.positiveTtl));
+    }
+
+    /// Queues the record for the writer, the records reach the store in the order they were written in
+    void write(const BanRecord& record) {
+        m_unwritten.push_back(record);
+        if (!flushWrites()) {
+            EXAMPLE_LOG_RATE_LIMITED(warn,
+                                     10,
+                                     10 * 1000,
+                                     "Ban queue is full, the ban for player ID {} will be written later",
+                                     record.playerid);
+        }
+    }
+
+    /// Hands the queued records over to the writer
+    /// @returns false if some records are still waiting for room in the writer's queue.
+    bool flushWrites() {
+        while (!m_unwritten.empty()) {
+            const BanRecord& record = m_unwritten.front();
+            if (!m_writer.tryPost([store = m_store, record] { store->store(record); })) {
+                return false;
+            }
+            m_unwritten.pop_front();
+        }
+        return true;
+    }
+
+    const Settings m_settings;
+    std::shared_ptr<BanStore> m_store;
+    BanCache m_cache;
+    std::unordered_map<PlayerKey, Pending, PlayerKeyHash> m_pending;
+    std::uint64_t m_sequence = 0;
+
+    std::mutex m_resultsMutex;
+    std::vector<Result> m_results;
+    std::vector<Result> m_completed;
+    std::deque<BanRecord> m_unwritten; ///< Records waiting for room in the writer's queue.
+
+    // Declared last so the workers are joined before the rest of the members is destroyed
+    util::WorkerPool m_workers;
+    util::WorkerPool m_writer; ///< A single thread, so the records are stored in order.
+};
+
+} // namespace example::ban
+
+#endif // PLUGPP_EXAMPLE_BAN_BANSERVICE_H
@@ -0,0 +1,247 @@
+#ifndef PLUGPP_EXAMPLE_BAN_BANSTORE_H
+#define PLUGPP_EXAMPLE_BAN_BANSTORE_H
+
+#include <spdlog/spdlog.h>
+
+#include <cod4-plugpp/Plugin.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace example::ban {
+
+/// A single ban as stored on disk
+struct BanRecord {
+    static constexpr std::uint32_t ACTIVE = 1;
+
+    std::uint64_t playerid;
+    std::uint64_t steamid;
+    std::int64_t expire; ///< Unix time when the ban expires, 0 for permanent bans.
+    std::uint32_t flags;
+    char reason[228];
+
+    bool isActive(const std::int64_t now) const {
+        return (flags & ACTIVE) && (expire == 0 || expire > now);
+    }
+
+    std::string_view getReason() const { return { reason, strnlen(reason, sizeof(reason)) }; }
+
+    void setReason(std::string_view text) {
+        text = text.substr(0, sizeof(reason) - 1);
+        std::memcpy(reason, text.data(), text.size());
+        std::memset(reason + text.size(), 0, sizeof(reason) - text.size());
+    }
+};
+static_assert(std::is_trivially_copyable_v<BanRecord>);
+static_assert(sizeof(BanRecord) == 256);
+
+/// Persistent ban store
+///
+/// The file is an append-only journal of fixed-size @ref BanRecord entries - a removed ban is just another
+/// record without the @ref BanRecord::ACTIVE flag. On startup the journal is mmap'ed and indexed by both the
+/// player ID and the steam ID, later records overriding the earlier ones. Lookups only touch the in-memory
+/// index and are safe to be done from multiple threads concurrently. A record torn by a crash is cut off the
+/// end of the journal, a journal with an unknown header is renamed aside and a new one is started.
+class BanStore {
+public:
+    explicit BanStore(std::string path)
+        : m_path(std::move(path)) {
+        Journal journal = load();
+        if (journal == Journal::INVALID) {
+            journal = setAside() ? Journal::MISSING : Journal::UNREADABLE;
+        }
+        if (journal == Journal::UNREADABLE) {
+            spdlog::error("The bans won't be saved into the ban store '{}'", m_path);
+            return;
+        }
+        m_fd = ::open(m_path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (m_fd < 0) {
+            spdlog::error("Failed to open the ban store '{}' for writing: {}", m_path, std::strerror(errno));
+            return;
+        }
+        const off_t end = ::lseek(m_fd, 0, SEEK_END);
+        if (journal == Journal::MISSING && end == 0) {
+            writeAll(&HEADER, sizeof(HEADER));
+        } else if (journal == Journal::VALID) {
+            // A record torn by a crash mid-write would shift all the records appended after it
+            const auto whole = static_cast<off_t>(sizeof(Header) + m_records * sizeof(BanRecord));
+            if (end != whole) {
+                spdlog::warn("Dropping a torn record at the end of the ban store '{}'", m_path);
+                if (::ftruncate(m_fd, whole) != 0) {
+                    spdlog::error(
+                        "Failed to truncate the ban store '{}': {}", m_path, std::strerror(errno));
+                    ::close(m_fd);
+                    m_fd = -1;
+                }
+            }
+        }
+    }
+
+    BanStore(const BanStore&) = delete;
+    BanStore& operator=(const BanStore&) = delete;
+
+    ~BanStore() noexcept {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    /// Finds an active ban matching either of the IDs
+    plugpp::Optional<BanRecord> find(const std::uint64_t playerid, const std::uint64_t steamid) const {
+        const std::int64_t now = std::time(nullptr);
+        std::shared_lock lock(m_mutex);
+        for (const auto& [index, id] :
+             { std::pair(&m_byPlayerId, playerid), std::pair(&m_bySteamId, steamid) }) {
+            if (id == 0) {
+                continue;
+            }
+            if (auto it = index->find(id); it != index->end() && it->second.isActive(now)) {
+                return it->second;
+            }
+        }
+        return plugpp::NullOptional;
+    }
+
+    /// Stores the record and appends it to the journal
+    ///
+    /// Storing an inactive record removes the ban.
+    void store(const BanRecord& record) {
+        std::unique_lock lock(m_mutex);
+        index(record);
+        if (m_fd >= 0) {
+            writeAll(&record, sizeof(record));
+        }
+    }
+
+    std::size_t size() const {
+        std::shared_lock lock(m_mutex);
+        return m_byPlayerId.size();
+    }
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+    };
+    static constexpr Header HEADER{ { 'P', 'P', 'X', 'B', 'A', 'N', 'S', '\0' }, 1, sizeof(BanRecord) };
+
+    enum class Journal : std::uint8_t {
+        MISSING,    ///< No journal or an empty one
+        VALID,      ///< Loaded, possibly with a torn record at the end
+        INVALID,    ///< A short or unknown header
+        UNREADABLE, ///< Couldn't be read, it's left alone
+    };
+
+    Journal load() {
+        const int fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == ENOENT) {
+                return Journal::MISSING;
+            }
+            spdlog::error("Failed to open the ban store '{}': {}", m_path, std::strerror(errno));
+            return Journal::UNREADABLE;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            spdlog::error("Failed to stat the ban store '{}': {}", m_path, std::strerror(errno));
+            ::close(fd);
+            return Journal::UNREADABLE;
+        }
+        if (st.st_size < static_cast<off_t>(sizeof(Header))) {
+            ::close(fd);
+            return st.st_size == 0 ? Journal::MISSING : Journal::INVALID;
+        }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            spdlog::error("Failed to map the ban store '{}': {}", m_path, std::strerror(errno));
+            return Journal::UNREADABLE;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+
+        const auto* bytes = static_cast<const char*>(data);
+        const bool valid = std::memcmp(bytes, &HEADER, sizeof(Header)) == 0;
+        if (valid) {
+            const std::size_t count = (size - sizeof(Header)) / sizeof(BanRecord);
+            m_byPlayerId.reserve(count);
+            m_bySteamId.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                BanRecord record;
+                std::memcpy(&record, bytes + sizeof(Header) + i * sizeof(BanRecord), sizeof(record));
+                index(record);
+            }
+            m_records = count;
+            spdlog::info("Loaded {} bans from '{}'", m_byPlayerId.size(), m_path);
+        }
+        ::munmap(data, size);
+        return valid ? Journal::VALID : Journal::INVALID;
+    }
+
+    /// Moves an invalid journal out of the way so a new one can be started, keeping it for inspection
+    bool setAside() {
+        const std::string aside = m_path + "." + std::to_string(std::time(nullptr)) + ".bad";
+        if (std::rename(m_path.c_str(), aside.c_str()) != 0) {
+            spdlog::error(
+                "Failed to move the invalid ban store '{}' aside: {}", m_path, std::strerror(errno));
+            return false;
+        }
+        spdlog::error("The ban store '{}' has an unknown format, moved it to '{}'", m_path, aside);
+        return true;
+    }
+
+    void index(const BanRecord& record) {
+        for (const auto& [index, id] : { std::pair(&m_byPlayerId, record.playerid),
+                                         std::pair(&m_bySteamId, record.steamid) }) {
+            if (id == 0) {
+                continue;
+            }
+            if (record.flags & BanRecord::ACTIVE) {
+                (*index)[id] = record;
+            } else {
+                index->erase(id);
+            }
+        }
+    }
+
+    void writeAll(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            const ssize_t written = ::write(m_fd, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                spdlog::error("Failed to write into the ban store '{}': {}", m_path, std::strerror(errno));
+                return;
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    const std::string m_path;
+    int m_fd = -1;
+    std::size_t m_records = 0;
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::uint64_t, BanRecord> m_byPlayerId;
+    std::unordered_map<std::uint64_t, BanRecord> m_bySteamId;
+};
+
+} // namespace example::ban
+
+#endif // PLUGPP_EXAMPLE_BAN_BANSTORE_H
@@ -0,0 +1,69 @@
+#ifndef PLUGPP_EXAMPLE_CHAT_CHATFILTER_H
+#define PLUGPP_EXAMPLE_CHAT_CHATFILTER_H
+
+#include "plugpp-example/chat/WordFilter.h"
+#include "plugpp-example/util/WorkerPool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace example::chat {
+
+/// The currently active @ref WordFilter which can be replaced at any time
+///
+/// Word lists are compiled in the background and the new automaton is swapped in atomically, so matching
+/// never waits for a reload.
+class ChatFilter {
+public:
+    ChatFilter()
+        : m_filter(std::make_shared<const WordFilter>(std::vector<std::string>{}))
+        , m_loader(1, 1) {}
+
+    /// Returns true if the message contains any of the patterns of the active word list
+    bool matches(const std::string_view message) const {
+        return std::atomic_load(&m_filter)->matches(message);
+    }
+
+    /// Compiles the word list in the background and activates it once it's ready
+    /// @returns false if a reload is already in progress.
+    bool reload(std::string path) {
+        return m_loader.tryPost([this, path = std::move(path)] {
+            struct stat st {};
+            if (::stat(path.c_str(), &st) != 0 && errno == ENOENT) {
+                // Not having a list is the default, not an error
+                if (!m_missing) {
+                    spdlog::info("No chat word list at '{}', no messages are hidden", path);
+                    m_missing = true;
+                }
+                std::atomic_store(&m_filter, std::make_shared<const WordFilter>(std::vector<std::string>{}));
+                return;
+            }
+            m_missing = false;
+            const auto start = std::chrono::steady_clock::now();
+            auto filter = std::make_shared<const WordFilter>(WordFilter::fromFile(path));
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            spdlog::info("Loaded {} chat patterns ({} states) from '{}' in {} ms",
+                         filter->patterns(),
+                         filter->states(),
+                         path,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+            std::atomic_store(&m_filter, std::shared_ptr<const WordFilter>(std::move(filter)));
+        });
+    }
+
+private:
+    std::shared_ptr<const WordFilter> m_filter;
+    bool m_missing = false; ///< The missing list was reported, only used by the loader.
+    util::WorkerPool m_loader;
+};
+
+} // namespace example::chat
+
+#endif // PLUGPP_EXAMPLE_CHAT_CHATFILTER_H
@@ -0,0 +1,273 @@
+#ifndef PLUGPP_EXAMPLE_CHAT_WORDFILTER_H
+#define PLUGPP_EXAMPLE_CHAT_WORDFILTER_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace example::chat {
+
+namespace detail {
+
+    /// Symbol the letters 'a' - 'z' are followed by
+    constexpr std::uint8_t SEPARATOR = 26;
+
+    /// Maps every character onto the symbol it's matched as
+    constexpr std::array<std::uint8_t, 256> makeSymbols() {
+        std::array<std::uint8_t, 256> symbols{};
+        for (auto& symbol : symbols) {
+            symbol = SEPARATOR;
+        }
+        for (int c = 'a'; c <= 'z'; ++c) {
+            symbols[c] = static_cast<std::uint8_t>(c - 'a');
+            symbols[c - 'a' + 'A'] = static_cast<std::uint8_t>(c - 'a');
+        }
+        constexpr std::pair<char, char> LEETSPEAK[] = {
+            { '0', 'o' }, { '1', 'i' }, { '2', 'z' }, { '3', 'e' }, { '4', 'a' }, { '5', 's' }, { '6', 'g' },
+            { '7', 't' }, { '8', 'b' }, { '9', 'g' }, { '@', 'a' }, { '$', 's' }, { '!', 'i' }, { '|', 'l' },
+        };
+        for (const auto& [from, to] : LEETSPEAK) {
+            symbols[static_cast<std::uint8_t>(from)] = static_cast<std::uint8_t>(to - 'a');
+        }
+        return symbols;
+    }
+
+    constexpr std::array<std::uint8_t, 256> SYMBOLS = makeSymbols();
+
+} // namespace detail
+
+/// Multi-pattern matcher for chat messages
+///
+/// The patterns are compiled into an Aho-Corasick automaton with a complete transition table, so matching a
+/// message is a single table lookup per character and never allocates. Both the patterns and the messages
+/// are normalized the same way before matching:
+///  - letters are case-folded,
+///  - colour codes (`^0` - `^9`) are skipped,
+///  - common leetspeak substitutions are mapped back to letters (`sh1t` matches `shit`), but only within
+///    words with at least one letter, so numbers like `455` stay numbers,
+///  - any run of other characters collapses into a single separator.
+///
+/// A pattern matches anywhere in a message, unless it starts or ends with @ref WORD_BOUNDARY (`\b`): then
+/// it only matches at the start or the end of a word (`\bass\b` matches "you ass" but not "class").
+class WordFilter {
+public:
+    /// Marks a pattern which only matches at the start or the end of a word
+    static constexpr std::string_view WORD_BOUNDARY = "\\b";
+
+    /// Compiles the patterns
+    explicit WordFilter(const std::vector<std::string>& patterns) {
+        m_transitions.assign(ALPHABET_SIZE, 0);
+        std::vector<bool> terminal(1, false);
+
+        // Trie of the normalized patterns
+        for (std::string_view pattern : patterns) {
+            const bool wordStart = consumePrefix(pattern, WORD_BOUNDARY);
+            const bool wordEnd = consumeSuffix(pattern, WORD_BOUNDARY);
+            std::uint32_t state = 0;
+            std::size_t letters = 0;
+            std::uint8_t last = SEPARATOR;
+            const auto add = [&](const std::uint8_t symbol) {
+                std::uint32_t& next = m_transitions[state * ALPHABET_SIZE + symbol];
+                if (next == 0) {
+                    next = static_cast<std::uint32_t>(terminal.size());
+                    terminal.push_back(false);
+                    m_transitions.resize(m_transitions.size() + ALPHABET_SIZE, 0);
+                }
+                state = m_transitions[state * ALPHABET_SIZE + symbol];
+                letters += symbol != SEPARATOR ? 1 : 0;
+                last = symbol;
+                return true;
+            };
+            // The boundaries are separators, the messages are matched as if surrounded by them
+            if (wordStart) {
+                add(SEPARATOR);
+            }
+            forEachSymbol(pattern, add);
+            if (wordEnd && last != SEPARATOR) {
+                add(SEPARATOR);
+            }
+            if (letters > 0) {
+                terminal[state] = true;
+                ++m_patterns;
+            }
+        }
+
+        // Failure links turn the trie into a complete automaton, visited in breadth-first order
+        std::vector<std::uint32_t> fail(terminal.size(), 0);
+        std::queue<std::uint32_t> queue;
+        for (std::uint32_t symbol = 0; symbol < ALPHABET_SIZE; ++symbol) {
+            if (const std::uint32_t next = m_transitions[symbol]; next != 0) {
+                queue.push(next);
+            }
+        }
+        while (!queue.empty()) {
+            const std::uint32_t state = queue.front();
+            queue.pop();
+            terminal[state] = terminal[state] || terminal[fail[state]];
+            for (std::uint32_t symbol = 0; symbol < ALPHABET_SIZE; ++symbol) {
+                std::uint32_t& next = m_transitions[state * ALPHABET_SIZE + symbol];
+                const std::uint32_t fallback = m_transitions[fail[state] * ALPHABET_SIZE + symbol];
+                if (next != 0) {
+                    fail[next] = fallback;
+                    queue.push(next);
+                } else {
+                    next = fallback;
+                }
+            }
+        }
+
+        // Terminal states are encoded directly in the transitions leading to them
+        for (auto& next : m_transitions) {
+            if (terminal[next]) {
+                next |= MATCH;
+            }
+        }
+    }
+
+    /// Loads the patterns from a file, one pattern per line
+    ///
+    /// Empty lines and lines starting with `#` are ignored.
+    /// @throws std::runtime_error if the file can't be read.
+    static WordFilter fromFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("Can't open the word list '" + path + "'");
+        }
+        std::vector<std::string> patterns;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty() && line.front() != '#') {
+                patterns.push_back(std::move(line));
+            }
+        }
+        return WordFilter(patterns);
+    }
+
+    /// Returns true if the message contains any of the patterns
+    bool matches(const std::string_view message) const {
+        if (m_patterns == 0) {
+            return false;
+        }
+        std::uint32_t state = 0;
+        std::uint8_t last = SEPARATOR;
+        const auto step = [&](const std::uint8_t symbol) {
+            state = m_transitions[(state & ~MATCH) * ALPHABET_SIZE + symbol];
+            last = symbol;
+            return (state & MATCH) == 0;
+        };
+        step(SEPARATOR);
+        forEachSymbol(message, step);
+        if ((state & MATCH) == 0 && last != SEPARATOR) {
+            step(SEPARATOR);
+        }
+        return (state & MATCH) != 0;
+    }
+
+    std::size_t patterns() const { return m_patterns; }
+
+    std::size_t states() const { return m_transitions.size() / ALPHABET_SIZE; }
+
+private:
+    static constexpr std::uint32_t ALPHABET_SIZE = detail::SEPARATOR + 1;
+    static constexpr std::uint8_t SEPARATOR = detail::SEPARATOR;
+    static constexpr std::uint32_t MATCH = 0x80000000U;
+
+    static bool consumePrefix(std::string_view& text, const std::string_view prefix) {
+        if (text.substr(0, prefix.size()) != prefix) {
+            return false;
+        }
+        text.remove_prefix(prefix.size());
+        return true;
+    }
+
+    static bool consumeSuffix(std::string_view& text, const std::string_view suffix) {
+        if (text.size() < suffix.size() || text.substr(text.size() - suffix.size()) != suffix) {
+            return false;
+        }
+        text.remove_suffix(suffix.size());
+        return true;
+    }
+
+    static bool isColorCode(const std::string_view text, const std::size_t i) {
+        return text[i] == '^' && i + 1 < text.size() && text[i + 1] >= '0' && text[i + 1] <= '9';
+    }
+
+    static bool isLetter(const char c) { return static_cast<unsigned>((c | 0x20) - 'a') < 26; }
+
+    /// Returns true if the rest of the word starting at the given position has a letter
+    static bool hasLetter(const std::string_view text, std::size_t i) {
+        for (; i < text.size(); ++i) {
+            if (isColorCode(text, i)) {
+                ++i;
+            } else if (isLetter(text[i])) {
+                return true;
+            } else if (detail::SYMBOLS[static_cast<std::uint8_t>(text[i])] == SEPARATOR) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    /// Returns true if only exclamation marks are left of the word at the given position
+    static bool endsWord(const std::string_view text, std::size_t i) {
+        while (i < text.size() && text[i] == '!') {
+            ++i;
+        }
+        return i == text.size() || detail::SYMBOLS[static_cast<std::uint8_t>(text[i])] == SEPARATOR;
+    }
+
+    /// Calls the function for each symbol of the normalized text until it returns false
+    template <typename Fn>
+    static void forEachSymbol(const std::string_view text, Fn&& fn) {
+        bool separated = true;
+        bool inWord = false;
+        bool spelled = false; ///< The current word has a letter, its digits and symbols stand for letters.
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            if (isColorCode(text, i)) {
+                ++i;
+                continue;
+            }
+            std::uint8_t symbol = detail::SYMBOLS[static_cast<std::uint8_t>(text[i])];
+            if (symbol != SEPARATOR) {
+                if (!inWord) {
+                    // Most words start with a letter, only the others are looked ahead at
+                    inWord = true;
+                    spelled = isLetter(text[i]) || hasLetter(text, i + 1);
+                }
+                // Exclamation marks ending a word are punctuation ("crap!"), not letters ("sh!t")
+                if (!spelled || (text[i] == '!' && endsWord(text, i + 1))) {
+                    symbol = SEPARATOR;
+                }
+            } else {
+                inWord = false;
+            }
+            if (symbol == SEPARATOR) {
+                if (separated) {
+                    continue;
+                }
+                separated = true;
+            } else {
+                separated = false;
+            }
+            if (!fn(symbol)) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> m_transitions;
+    std::size_t m_patterns = 0;
+};
+
+} // namespace example::chat
+
+#endif // PLUGPP_EXAMPLE_CHAT_WORDFILTER_H
@@ -0,0 +1,88 @@
+#ifndef PLUGPP_EXAMPLE_CONSOLE_COMMANDS_H
+#define PLUGPP_EXAMPLE_CONSOLE_COMMANDS_H
+
+#include <spdlog/spdlog.h>
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace example::console {
+
+/// Arguments of the console command being executed
+class CommandArgs {
+public:
+    /// Returns the number of arguments including the command name
+    int count() const { return Plugin_Cmd_Argc(); }
+
+    std::string_view operator[](const int i) const {
+        const char* arg = Plugin_Cmd_Argv(i);
+        return arg ? std::string_view(arg) : std::string_view();
+    }
+};
+
+/// Console commands implemented by the plugin
+///
+/// The server only accepts plain function pointers as command handlers, so all the commands share a single
+/// trampoline which dispatches on the command name.
+class Commands {
+public:
+    using Handler = std::function<void(const CommandArgs&)>;
+
+    Commands() = default;
+    Commands(const Commands&) = delete;
+    Commands& operator=(const Commands&) = delete;
+
+    /// Registers a console command
+    ///
+    /// @param name Name of the command.
+    /// @param power The minimal power an admin needs to execute the command.
+    /// @param handler The function to execute.
+    void add(std::string name, const int power, Handler handler) {
+        auto [it, inserted] = m_handlers.insert_or_assign(name, std::move(handler));
+        if (inserted) {
+            Plugin_AddCommand(const_cast<char*>(it->first.c_str()), &Commands::dispatch, power);
+        }
+    }
+
+    /// Unbinds all the handlers
+    ///
+    /// The commands stay registered with the server, executing them does nothing until they are bound again.
+    void clear() {
+        for (auto& [name, handler] : m_handlers) {
+            handler = nullptr;
+        }
+    }
+
+private:
+    static void dispatch();
+
+    std::map<std::string, Handler, std::less<>> m_handlers;
+};
+
+/// The commands registered by the plugin
+inline Commands& commands() {
+    static Commands instance;
+    return instance;
+}
+
+inline void Commands::dispatch() {
+    const CommandArgs args;
+    auto& handlers = commands().m_handlers;
+    auto it = handlers.find(args[0]);
+    if (it == handlers.end() || !it->second) {
+        return;
+    }
+    try {
+        it->second(args);
+    } catch (const std::exception& e) {
+        spdlog::error("Command '{}' failed: {}", it->first, e.what());
+    }
+}
+
+} // namespace example::console
+
+#endif // PLUGPP_EXAMPLE_CONSOLE_COMMANDS_H
@@ -0,0 +1,45 @@
+#ifndef PLUGPP_EXAMPLE_CONSOLE_CVAR_H
+#define PLUGPP_EXAMPLE_CONSOLE_CVAR_H
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <string>
+
+namespace example::console {
+
+/// Integer console variable registered with the server
+///
+/// Reading the value is a plain pointer dereference on the server side, so it's cheap enough to be done
+/// every frame.
+class IntCvar {
+public:
+    IntCvar(const char* name, int value, int min, int max, const char* description)
+        : m_cvar(Plugin_Cvar_RegisterInt(name, value, min, max, 0, description)) {}
+
+    int get() const { return Plugin_Cvar_GetInteger(m_cvar); }
+
+private:
+    const CONVAR_T* m_cvar;
+};
+
+/// String console variable registered with the server
+class StringCvar {
+public:
+    StringCvar(const char* name, const char* value, const char* description)
+        : m_name(name) {
+        Plugin_Cvar_RegisterString(name, value, 0, description);
+    }
+
+    std::string get() const {
+        char buffer[256];
+        Plugin_Cvar_VariableStringBuffer(m_name, buffer, sizeof(buffer));
+        return buffer;
+    }
+
+private:
+    const char* m_name;
+};
+
+} // namespace example::console
+
+#endif // PLUGPP_EXAMPLE_CONSOLE_CVAR_H
@@ -0,0 +1,349 @@
+#ifndef PLUGPP_EXAMPLE_GSC_USERCALLS_H
+#define PLUGPP_EXAMPLE_GSC_USERCALLS_H
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace example::gsc {
+
+/// A vector argument or result of a usercall
+using Vec3 = std::array<float, 3>;
+
+/// Declares the member function handling the usercall of the given name, see @ref makeFunctions()
+template <auto Method>
+struct Usercall {
+    std::string_view name;
+};
+
+template <auto Method>
+constexpr Usercall<Method> usercall(const std::string_view name) {
+    return { name };
+}
+
+namespace detail {
+
+    /// Reads a parameter of the script call, the engine raises a script error when its type doesn't match
+    template <typename T>
+    struct Param;
+
+    template <>
+    struct Param<int> {
+        static constexpr std::string_view NAME = "int";
+        static int get(const unsigned int i) { return Plugin_Scr_GetInt(i); }
+    };
+
+    template <>
+    struct Param<bool> {
+        static constexpr std::string_view NAME = "bool";
+        static bool get(const unsigned int i) { return Plugin_Scr_GetInt(i) != 0; }
+    };
+
+    template <>
+    struct Param<float> {
+        static constexpr std::string_view NAME = "float";
+        static float get(const unsigned int i) { return Plugin_Scr_GetFloat(i); }
+    };
+
+    /// Points to the script's string, valid for the duration of the call
+    template <>
+    struct Param<std::string_view> {
+        static constexpr std::string_view NAME = "string";
+        static std::string_view get(const unsigned int i) { return Plugin_Scr_GetString(i); }
+    };
+
+    template <>
+    struct Param<const char*> {
+        static constexpr std::string_view NAME = "string";
+        static const char* get(const unsigned int i) { return Plugin_Scr_GetString(i); }
+    };
+
+    template <>
+    struct Param<Vec3> {
+        static constexpr std::string_view NAME = "vector";
+        static Vec3 get(const unsigned int i) {
+            vec3_t v;
+            Plugin_Scr_GetVector(i, &v);
+            return { v[0], v[1], v[2] };
+        }
+    };
+
+    template <>
+    struct Param<gentity_t*> {
+        static constexpr std::string_view NAME = "entity";
+        static gentity_t* get(const unsigned int i) { return Plugin_Scr_GetEntity(i); }
+    };
+
+    /// Longest string result, longer ones are cut
+    constexpr std::size_t MAX_RESULT_STRING = 1023;
+
+    inline void addResult(const int value) { Plugin_Scr_AddInt(value); }
+    inline void addResult(const bool value) { Plugin_Scr_AddInt(value ? 1 : 0); }
+    inline void addResult(const float value) { Plugin_Scr_AddFloat(value); }
+    inline void addResult(const char* value) { Plugin_Scr_AddString(value); }
+
+    inline void addResult(Vec3 value) {
+        vec3_t v = { value[0], value[1], value[2] };
+        Plugin_Scr_AddVector(v);
+    }
+
+    /// The engine copies the string, so the views don't need to be terminated
+    inline void addResult(const std::string_view value) {
+        char text[MAX_RESULT_STRING + 1];
+        const std::size_t length = std::min(value.size(), MAX_RESULT_STRING);
+        std::memcpy(text, value.data(), length);
+        text[length] = '\0';
+        Plugin_Scr_AddString(text);
+    }
+
+    template <typename T>
+    struct MemberTraits;
+
+    template <typename C, typename R, typename... P>
+    struct MemberTraits<R (C::*)(P...)> {
+        using Result = R;
+        using Params = std::tuple<std::decay_t<P>...>;
+    };
+
+    /// Type of the I-th script parameter, following the leading parameters passed by the caller
+    template <auto Method, std::size_t LEADING, std::size_t I>
+    using ParamType = std::tuple_element_t<LEADING + I, typename MemberTraits<decltype(Method)>::Params>;
+
+    /// Raises a script error describing the signature of the usercall
+    ///
+    /// The error may not return to the caller, so nothing here may need a destructor.
+    template <auto Method, std::size_t LEADING, std::size_t... I>
+    void usageError(const std::string_view name, std::index_sequence<I...>) {
+        char text[256];
+        std::size_t length = 0;
+        const auto append = [&text, &length](const std::string_view part) {
+            const std::size_t n = std::min(part.size(), sizeof(text) - 1 - length);
+            std::memcpy(text + length, part.data(), n);
+            length += n;
+        };
+        append("usage: usercall(\"");
+        append(name);
+        append("\"");
+        ((append(", "), append(Param<ParamType<Method, LEADING, I>>::NAME)), ...);
+        append(")");
+        text[length] = '\0';
+        Plugin_Scr_Error(text);
+    }
+
+    template <auto Method, typename Owner, typename... Leading, std::size_t... I>
+    void invoke(Owner& owner, std::index_sequence<I...>, Leading... leading) {
+        constexpr std::size_t LEADING = sizeof...(Leading);
+        using Result = typename MemberTraits<decltype(Method)>::Result;
+        if constexpr (std::is_void_v<Result>) {
+            (owner.*Method)(leading..., Param<ParamType<Method, LEADING, I>>::get(I)...);
+        } else {
+            addResult((owner.*Method)(leading..., Param<ParamType<Method, LEADING, I>>::get(I)...));
+        }
+    }
+
+    /// Checks the number of the script's parameters and calls the handler with them
+    template <auto Method, typename Owner, typename... Leading>
+    void dispatch(Owner& owner, const std::string_view name, Leading... leading) {
+        constexpr std::size_t LEADING = sizeof...(Leading);
+        constexpr std::size_t ARITY =
+            std::tuple_size_v<typename MemberTraits<decltype(Method)>::Params> - LEADING;
+        if (Plugin_Scr_GetNumParam() != static_cast<int>(ARITY)) {
+            usageError<Method, LEADING>(name, std::make_index_sequence<ARITY>{});
+            return;
+        }
+        invoke<Method>(owner, std::make_index_sequence<ARITY>{}, leading...);
+    }
+
+    /// Little-endian load of 8 bytes, std::memcpy isn't usable while building the table at compile time
+    constexpr std::uint64_t load(const char* p) {
+        std::uint64_t word = 0;
+        if (__builtin_is_constant_evaluated()) {
+            for (std::size_t i = 0; i < 8; ++i) {
+                word |= std::uint64_t{ static_cast<std::uint8_t>(p[i]) } << (8 * i);
+            }
+        } else {
+            std::memcpy(&word, p, sizeof(word));
+        }
+        return word;
+    }
+
+    /// Hash of the name, computed once per call, 8 bytes at a time
+    constexpr std::uint64_t hash(const std::string_view name) {
+        constexpr std::uint64_t PRIME = 0x100000001B3ULL;
+        std::uint64_t h = 0xCBF29CE484222325ULL ^ name.size();
+        if (name.size() < 8) {
+            for (const char c : name) {
+                h = (h ^ static_cast<std::uint8_t>(c)) * PRIME;
+            }
+            return h;
+        }
+        for (std::size_t i = 0; i + 8 < name.size(); i += 8) {
+            h = (h ^ load(name.data() + i)) * PRIME;
+            h ^= h >> 29;
+        }
+        // The last 8 bytes, overlapping the previous word unless the size is a multiple of 8
+        return (h ^ load(name.data() + name.size() - 8)) * PRIME;
+    }
+
+    /// Remixes the hash with the displacement seed of its bucket
+    constexpr std::uint32_t displace(std::uint64_t h, const std::uint32_t seed) {
+        h ^= (seed + 1) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return static_cast<std::uint32_t>(h);
+    }
+
+    constexpr std::size_t powerOfTwo(const std::size_t n) {
+        std::size_t size = 1;
+        while (size < n) {
+            size *= 2;
+        }
+        return size;
+    }
+
+} // namespace detail
+
+/// Dispatch table of usercalls built at compile time
+///
+/// The names are placed by a perfect hash (hash and displace): the hash of a name selects a bucket, and the
+/// displacement seed of the bucket, searched for by the constructor, remixes the hash into a slot no other
+/// name occupies. A call hashes the name once, compares it with a single candidate and jumps to the handler,
+/// which unpacks the script's parameters according to its signature. Nothing allocates or copies the name.
+/// @tparam Leading Parameters the caller passes to every handler before the script's ones, e.g., the slot.
+template <typename Owner, std::size_t N, typename... Leading>
+class UsercallTable {
+public:
+    using Handler = void (*)(Owner&, std::string_view, Leading...);
+
+    struct Entry {
+        std::string_view name;
+        Handler handler;
+    };
+
+    static constexpr std::size_t SIZE = detail::powerOfTwo(2 * N);
+    static constexpr std::size_t BUCKETS = detail::powerOfTwo((N + 1) / 2);
+
+    constexpr explicit UsercallTable(const std::array<Entry, N>& entries)
+        : m_entries(entries) {
+        std::array<std::size_t, N> bucket{};
+        std::array<std::size_t, BUCKETS> bucketSize{};
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < i; ++j) {
+                if (m_entries[i].name == m_entries[j].name) {
+                    throw std::logic_error("Duplicate usercall name");
+                }
+            }
+            bucket[i] = detail::hash(m_entries[i].name) & (BUCKETS - 1);
+            ++bucketSize[bucket[i]];
+        }
+        for (std::size_t i = 0; i < SIZE; ++i) {
+            m_slots[i] = -1;
+        }
+        // The largest buckets first, while there's still a lot of free slots
+        for (std::size_t size = N; size > 0; --size) {
+            for (std::size_t b = 0; b < BUCKETS; ++b) {
+                if (bucketSize[b] == size && !placeBucket(bucket, b)) {
+                    throw std::logic_error("No perfect hash found for the usercall names");
+                }
+            }
+        }
+    }
+
+    /// Calls the handler of the usercall with the script's parameters
+    /// @returns false if the table has no such usercall.
+    bool call(Owner& owner, const std::string_view name, Leading... leading) const {
+        const std::uint64_t h = detail::hash(name);
+        const std::int16_t index = m_slots[detail::displace(h, m_seeds[h & (BUCKETS - 1)]) & (SIZE - 1)];
+        if (index < 0 || m_entries[static_cast<std::size_t>(index)].name != name) {
+            return false;
+        }
+        m_entries[static_cast<std::size_t>(index)].handler(owner, name, leading...);
+        return true;
+    }
+
+private:
+    static constexpr std::uint32_t MAX_SEED = 0xFFFF;
+    static_assert(N < 0x8000);
+
+    /// Searches for the seed which places all the names of the bucket into free slots
+    constexpr bool placeBucket(const std::array<std::size_t, N>& bucket, const std::size_t b) {
+        for (std::uint32_t seed = 0; seed <= MAX_SEED; ++seed) {
+            std::size_t placed = 0;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (bucket[i] != b) {
+                    continue;
+                }
+                std::int16_t& slot = m_slots[slotOf(i, seed)];
+                if (slot >= 0) {
+                    break;
+                }
+                slot = static_cast<std::int16_t>(i);
+                ++placed;
+            }
+            if (placed == countOf(bucket, b)) {
+                m_seeds[b] = static_cast<std::uint16_t>(seed);
+                return true;
+            }
+            // Take the bucket's names out again
+            for (std::size_t i = 0; i < N && placed > 0; ++i) {
+                if (bucket[i] == b) {
+                    m_slots[slotOf(i, seed)] = -1;
+                    --placed;
+                }
+            }
+        }
+        return false;
+    }
+
+    constexpr std::size_t slotOf(const std::size_t i, const std::uint32_t seed) const {
+        return detail::displace(detail::hash(m_entries[i].name), seed) & (SIZE - 1);
+    }
+
+    static constexpr std::size_t countOf(const std::array<std::size_t, N>& bucket, const std::size_t b) {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            count += bucket[i] == b ? 1 : 0;
+        }
+        return count;
+    }
+
+    std::array<Entry, N> m_entries;
+    std::array<std::uint16_t, BUCKETS> m_seeds{};
+    std::array<std::int16_t, SIZE> m_slots{};
+};
+
+/// Builds the table of usercall functions, e.g.,
+/// `static constexpr auto FUNCTIONS = makeFunctions<Plugin>(usercall<&Plugin::print>("print"));`
+///
+/// The handlers are member functions taking the script's parameters, their result (if any) is returned to
+/// the script. Parameters may be int, bool, float, std::string_view, const char*, @ref Vec3 or gentity_t*,
+/// results int, bool, float, const char*, std::string_view or @ref Vec3.
+template <typename Owner, auto... Methods>
+constexpr auto makeFunctions(const Usercall<Methods>&... usercalls) {
+    using Table = UsercallTable<Owner, sizeof...(Methods)>;
+    return Table(std::array<typename Table::Entry, sizeof...(Methods)>{
+        typename Table::Entry{ usercalls.name, &detail::dispatch<Methods, Owner> }... });
+}
+
+/// Builds the table of usercall methods, the handlers take the slot of the player followed by the script's
+/// parameters, see @ref makeFunctions()
+template <typename Owner, auto... Methods>
+constexpr auto makeMethods(const Usercall<Methods>&... usercalls) {
+    using Table = UsercallTable<Owner, sizeof...(Methods), int>;
+    return Table(std::array<typename Table::Entry, sizeof...(Methods)>{
+        typename Table::Entry{ usercalls.name, &detail::dispatch<Methods, Owner, int> }... });
+}
+
+} // namespace example::gsc
+
+#endif // PLUGPP_EXAMPLE_GSC_USERCALLS_H
@@ -0,0 +1,163 @@
+#ifndef PLUGPP_EXAMPLE_IO_CONSOLEQUEUE_H
+#define PLUGPP_EXAMPLE_IO_CONSOLEQUEUE_H
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace example::io {
+
+/// What happens to a line which doesn't fit into the full queue
+enum class OverflowPolicy {
+    DROP,     ///< The line is silently dropped and counted.
+    COALESCE, ///< The line is dropped, but a single "N lines suppressed" notice gets printed in its place.
+};
+
+struct ConsoleQueueStats {
+    std::uint64_t enqueued;
+    std::uint64_t printed;
+    std::uint64_t dropped;
+    std::uint64_t truncated;
+};
+
+/// Bounded multi-producer single-consumer queue of console lines
+///
+/// Any thread may push a line, only the game thread drains the queue (and calls Plugin_Printf()). All the
+/// memory is allocated upfront, pushing never allocates and never blocks.
+class ConsoleQueue {
+public:
+    static constexpr std::size_t CAPACITY = 1024;
+    static constexpr std::size_t LINE_SIZE = 1000;
+
+    ConsoleQueue()
+        : m_slots(std::make_unique<Slot[]>(CAPACITY)) {
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ConsoleQueue(const ConsoleQueue&) = delete;
+    ConsoleQueue& operator=(const ConsoleQueue&) = delete;
+
+    /// Enqueues a line, truncating it to @ref LINE_SIZE characters
+    ///
+    /// @param text The text to print.
+    /// @param newline Whether a newline should be appended to the text when printing it.
+    /// @param truncated Whether the text has already been truncated by the caller.
+    /// @returns true if the line was queued, false if it was dropped because the queue is full.
+    bool push(std::string_view text, const bool newline, bool truncated = false) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &m_slots[pos % CAPACITY];
+            const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                if (m_policy.load(std::memory_order_relaxed) == OverflowPolicy::COALESCE) {
+                    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+                }
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        if (text.size() > LINE_SIZE) {
+            text = text.substr(0, LINE_SIZE);
+            truncated = true;
+        }
+        if (truncated) {
+            m_truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::memcpy(slot->text, text.data(), text.size());
+        slot->text[text.size()] = '\0';
+        slot->size = static_cast<std::uint16_t>(text.size());
+        slot->newline = newline;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        m_enqueued.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Prints queued lines until either of the budgets is exhausted
+    ///
+    /// Shall only be called from the game thread. At least one line is printed if there is any, even if it
+    /// exceeds the byte budget, so a long line can't stall the queue.
+    ///
+    /// @param maxBytes The maximum number of characters to print.
+    /// @param maxLines The maximum number of lines to print.
+    /// @returns The number of printed lines.
+    std::size_t drain(const std::size_t maxBytes, const std::size_t maxLines) {
+        if (const auto suppressed = m_suppressed.exchange(0, std::memory_order_relaxed); suppressed > 0) {
+            Plugin_Printf("^3[%u console lines suppressed]\n", static_cast<unsigned>(suppressed));
+        }
+
+        std::size_t bytes = 0;
+        std::size_t lines = 0;
+        while (lines < maxLines) {
+            Slot& slot = m_slots[m_dequeuePos % CAPACITY];
+            if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+                break;
+            }
+            if (lines > 0 && bytes + slot.size > maxBytes) {
+                break;
+            }
+            Plugin_Printf(slot.newline ? "%s\n" : "%s", slot.text);
+            bytes += slot.size;
+            ++lines;
+            slot.sequence.store(m_dequeuePos + CAPACITY, std::memory_order_release);
+            ++m_dequeuePos;
+        }
+        m_printed.fetch_add(lines, std::memory_order_relaxed);
+        return lines;
+    }
+
+    /// Prints everything that is queued regardless of any budget
+    void flush() { drain(SIZE_MAX, SIZE_MAX); }
+
+    void setOverflowPolicy(const OverflowPolicy policy) { m_policy.store(policy, std::memory_order_relaxed); }
+
+    ConsoleQueueStats stats() const {
+        return ConsoleQueueStats{ m_enqueued.load(std::memory_order_relaxed),
+                                  m_printed.load(std::memory_order_relaxed),
+                                  m_dropped.load(std::memory_order_relaxed),
+                                  m_truncated.load(std::memory_order_relaxed) };
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::size_t> sequence;
+        std::uint16_t size;
+        bool newline;
+        char text[LINE_SIZE + 1];
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{ 0 };
+    alignas(64) std::size_t m_dequeuePos = 0;
+    std::atomic<OverflowPolicy> m_policy{ OverflowPolicy::COALESCE };
+    std::atomic<std::uint64_t> m_suppressed{ 0 };
+    std::atomic<std::uint64_t> m_enqueued{ 0 };
+    std::atomic<std::uint64_t> m_printed{ 0 };
+    std::atomic<std::uint64_t> m_dropped{ 0 };
+    std::atomic<std::uint64_t> m_truncated{ 0 };
+};
+
+/// The queue all the print functions write into
+inline ConsoleQueue& consoleQueue() {
+    static ConsoleQueue queue;
+    return queue;
+}
+
+} // namespace example::io
+
+#endif // PLUGPP_EXAMPLE_IO_CONSOLEQUEUE_H
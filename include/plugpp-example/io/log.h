@@ -0,0 +1,158 @@
+#ifndef PLUGPP_EXAMPLE_IO_LOG_H
+#define PLUGPP_EXAMPLE_IO_LOG_H
+
+#include <spdlog/async.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace example::io {
+
+struct LogStats {
+    std::uint64_t overrun;     ///< Messages dropped because the logging queue was full.
+    std::uint64_t sampled;     ///< Messages skipped by EXAMPLE_LOG_EVERY_N().
+    std::uint64_t rateLimited; ///< Messages dropped by EXAMPLE_LOG_RATE_LIMITED().
+};
+
+namespace detail {
+
+    struct LogCounters {
+        std::atomic<std::uint64_t> sampled{ 0 };
+        std::atomic<std::uint64_t> rateLimited{ 0 };
+    };
+
+    inline LogCounters& logCounters() {
+        static LogCounters counters;
+        return counters;
+    }
+
+    inline std::shared_ptr<spdlog::details::thread_pool>& logThreadPool() {
+        static std::shared_ptr<spdlog::details::thread_pool> pool;
+        return pool;
+    }
+
+} // namespace detail
+
+/// Makes the default logger write into the sinks from a background thread
+///
+/// The messages are queued in a circular buffer of the given capacity allocated upfront, when it's full the
+/// oldest message is overwritten (and counted), so logging never blocks the game thread on I/O. The sinks
+/// are called from the logging thread only.
+inline void startLogging(const std::string& name,
+                         std::vector<spdlog::sink_ptr> sinks,
+                         const std::size_t capacity) {
+    auto& pool = detail::logThreadPool();
+    pool = std::make_shared<spdlog::details::thread_pool>(capacity, 1);
+    auto logger = std::make_shared<spdlog::async_logger>(name,
+                                                         std::make_move_iterator(sinks.begin()),
+                                                         std::make_move_iterator(sinks.end()),
+                                                         pool,
+                                                         spdlog::async_overflow_policy::overrun_oldest);
+    logger->set_level(spdlog::level::trace);
+    spdlog::set_default_logger(std::move(logger));
+}
+
+/// Asks the logging thread to flush the sinks, doesn't wait for it
+inline void flushLog() {
+    spdlog::default_logger_raw()->flush();
+}
+
+/// Writes the queued messages and stops the logging thread
+///
+/// The default logger keeps writing into the same sinks, synchronously, so the messages logged while the
+/// plugin is being torn down aren't lost.
+inline void stopLogging() {
+    auto& pool = detail::logThreadPool();
+    if (!pool) {
+        return;
+    }
+    const auto logger = spdlog::default_logger();
+    logger->flush();
+    pool.reset(); // Joins the thread once it has processed the queue
+    const auto& sinks = logger->sinks();
+    auto fallback = std::make_shared<spdlog::logger>(logger->name(), sinks.begin(), sinks.end());
+    fallback->set_level(logger->level());
+    spdlog::set_default_logger(std::move(fallback));
+    spdlog::default_logger_raw()->flush();
+}
+
+inline LogStats logStats() {
+    const auto& pool = detail::logThreadPool();
+    const auto& counters = detail::logCounters();
+    return { pool ? static_cast<std::uint64_t>(pool->overrun_counter()) : 0,
+             counters.sampled.load(std::memory_order_relaxed),
+             counters.rateLimited.load(std::memory_order_relaxed) };
+}
+
+/// State of a single logging statement, see EXAMPLE_LOG_EVERY_N() and EXAMPLE_LOG_RATE_LIMITED()
+///
+/// Meant to be a static local, it's constant-initialized and trivially destructible. Calls from several
+/// threads are counted approximately.
+class LogSite {
+public:
+    /// @returns true for the first of every n calls.
+    bool sample(const std::uint32_t n) {
+        if (n <= 1 || m_count.fetch_add(1, std::memory_order_relaxed) % n == 0) {
+            return true;
+        }
+        detail::logCounters().sampled.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /// Admits at most the given number of messages per interval
+    /// @returns -1 if the message shall be dropped, otherwise the number of messages dropped since the
+    /// previous admitted one.
+    std::int64_t admit(const std::uint32_t limit, const std::uint64_t intervalMs) {
+        using namespace std::chrono;
+        const auto now = static_cast<std::uint64_t>(
+            duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+        std::uint64_t start = m_windowStart.load(std::memory_order_relaxed);
+        if (now - start >= intervalMs &&
+            m_windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            m_count.store(0, std::memory_order_relaxed);
+        }
+        if (m_count.fetch_add(1, std::memory_order_relaxed) < limit) {
+            return static_cast<std::int64_t>(m_suppressed.exchange(0, std::memory_order_relaxed));
+        }
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        detail::logCounters().rateLimited.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+private:
+    std::atomic<std::uint32_t> m_count{ 0 };
+    std::atomic<std::uint64_t> m_windowStart{ 0 };
+    std::atomic<std::uint64_t> m_suppressed{ 0 };
+};
+
+} // namespace example::io
+
+/// Logs only every n-th message of this statement, e.g., `EXAMPLE_LOG_EVERY_N(debug, 100, "...", ...)`
+#define EXAMPLE_LOG_EVERY_N(severity, n, ...)                  \
+    do {                                                       \
+        static ::example::io::LogSite exampleLogSite_;         \
+        if (exampleLogSite_.sample(n)) {                       \
+            spdlog::log(spdlog::level::severity, __VA_ARGS__); \
+        }                                                      \
+    } while (false)
+
+/// Logs at most `limit` messages of this statement per interval, the next logged one is preceded by the
+/// number of the dropped ones
+#define EXAMPLE_LOG_RATE_LIMITED(severity, limit, intervalMs, ...)                                    \
+    do {                                                                                              \
+        static ::example::io::LogSite exampleLogSite_;                                                \
+        if (const std::int64_t dropped_ = exampleLogSite_.admit(limit, intervalMs); dropped_ >= 0) {  \
+            if (dropped_ > 0) {                                                                       \
+                spdlog::log(spdlog::level::severity, "{} similar messages were suppressed", dropped_); \
+            }                                                                                         \
+            spdlog::log(spdlog::level::severity, __VA_ARGS__);                                        \
+        }                                                                                             \
+    } while (false)
+
+#endif // PLUGPP_EXAMPLE_IO_LOG_H
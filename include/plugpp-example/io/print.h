@@ -7,21 +7,53 @@
 
 #include <cod4-plugpp/PluginApi.h>
 
+#include "plugpp-example/io/ConsoleQueue.h"
+
+#include <algorithm>
+
 namespace example::io {
 
+namespace detail {
+
+    /// Per-thread formatting buffer
+    ///
+    /// Deliberately a plain array - thread_local objects with a non-trivial destructor pin the plugin's
+    /// shared object in memory, which would break plugin reloading.
+    inline char* lineBuffer() {
+        thread_local char buffer[ConsoleQueue::LINE_SIZE];
+        return buffer;
+    }
+
+    template <typename... T>
+    inline void enqueue(const bool newline, fmt::format_string<T...> fmt, T&&... args) {
+        char* buffer = lineBuffer();
+        const auto result =
+            fmt::format_to_n(buffer, ConsoleQueue::LINE_SIZE, fmt, std::forward<T>(args)...);
+        const bool truncated = result.size > ConsoleQueue::LINE_SIZE;
+        consoleQueue().push({ buffer, std::min(result.size, ConsoleQueue::LINE_SIZE) }, newline, truncated);
+    }
+
+} // namespace detail
+
+/// Queues the formatted text to be printed into the server's console
+///
+/// The text is printed by the game thread during the next server frame(s), @see ConsoleQueue.
 template <typename... T>
 inline void print(fmt::format_string<T...> fmt, T&&... args) {
     try {
-        Plugin_Printf("%s", fmt::format(fmt, std::forward<T>(args)...).c_str());
+        detail::enqueue(false, fmt, std::forward<T>(args)...);
     } catch (const std::exception& e) {
         spdlog::error("Printing failed: {}", e.what());
     }
 }
 
+/// Queues the formatted line to be printed into the server's console
+///
+/// The line is printed by the game thread during the next server frame(s), @see ConsoleQueue.
 template <typename... T>
 inline void println(fmt::format_string<T...> fmt, T&&... args) {
     try {
-        Plugin_Printf("%s\n", fmt::format(fmt, std::forward<T>(args)...).c_str());
+        detail::enqueue(true, fmt, std::forward<T>(args)...);
     } catch (const std::exception& e) {
         spdlog::error("Printing failed: {}", e.what());
     }
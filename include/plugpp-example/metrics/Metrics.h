@@ -0,0 +1,248 @@
+#ifndef PLUGPP_EXAMPLE_METRICS_METRICS_H
+#define PLUGPP_EXAMPLE_METRICS_METRICS_H
+
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace example::metrics {
+
+/// Number of copies of every counter, the threads spread over them so they don't share cache lines
+constexpr std::size_t SHARDS = 4;
+
+/// Returns the shard of the calling thread, assigned round-robin on the thread's first use
+inline std::size_t shardIndex() {
+    static std::atomic<std::size_t> next{ 0 };
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+/// Monotonically increasing count, e.g., of packets
+///
+/// Adding is a single relaxed increment of the calling thread's shard, only the reader sums the shards up.
+class Counter {
+public:
+    void add(const std::uint64_t n = 1) {
+        m_shards[shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    std::uint64_t value() const {
+        std::uint64_t sum = 0;
+        for (const Shard& shard : m_shards) {
+            sum += shard.value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value{ 0 };
+    };
+
+    Shard m_shards[SHARDS];
+};
+
+/// Value which goes up and down, e.g., the number of players
+///
+/// Gauges are set by one thread rather than counted by many, so they aren't sharded.
+class Gauge {
+public:
+    void set(const std::int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+
+    void add(const std::int64_t n) { m_value.fetch_add(n, std::memory_order_relaxed); }
+
+    std::int64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> m_value{ 0 };
+};
+
+/// Distribution of integer values over fixed buckets, e.g., of durations in microseconds
+///
+/// Observing a value increments its bucket and the sum of the calling thread's shard. The count is the sum
+/// of the buckets.
+class Histogram {
+public:
+    static constexpr std::size_t MAX_BUCKETS = 15;
+
+    /// @param bounds Inclusive upper bounds of the buckets in ascending order, at most @ref MAX_BUCKETS of
+    /// them. The values above the last bound fall into an implicit overflow bucket.
+    /// @param unit Factor the values and the bounds are multiplied with when exposed, e.g., 1e-6 to expose
+    /// microseconds as seconds.
+    Histogram(const std::initializer_list<std::uint64_t> bounds, const double unit)
+        : m_size(std::min(bounds.size(), MAX_BUCKETS))
+        , m_unit(unit) {
+        std::copy_n(bounds.begin(), m_size, m_bounds);
+    }
+
+    void observe(const std::uint64_t value) {
+        std::size_t bucket = 0;
+        while (bucket < m_size && value > m_bounds[bucket]) {
+            ++bucket;
+        }
+        Shard& shard = m_shards[shardIndex()];
+        shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    std::size_t size() const { return m_size; }
+
+    std::uint64_t bound(const std::size_t bucket) const { return m_bounds[bucket]; }
+
+    double unit() const { return m_unit; }
+
+    /// Returns the number of values in the bucket, @ref size() is the overflow bucket
+    std::uint64_t count(const std::size_t bucket) const {
+        std::uint64_t sum = 0;
+        for (const Shard& shard : m_shards) {
+            sum += shard.buckets[bucket].load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    std::uint64_t sum() const {
+        std::uint64_t sum = 0;
+        for (const Shard& shard : m_shards) {
+            sum += shard.sum.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> buckets[MAX_BUCKETS + 1] = {};
+        std::atomic<std::uint64_t> sum{ 0 };
+    };
+
+    std::uint64_t m_bounds[MAX_BUCKETS] = {};
+    std::size_t m_size;
+    double m_unit;
+    Shard m_shards[SHARDS];
+};
+
+/// Named metrics of the plugin, exposed in the Prometheus text format
+///
+/// Metrics are registered once, e.g., when the plugin loads, and are then updated through the returned
+/// references without touching the registry. Registering and exposing are serialized by a mutex, so the
+/// metrics can be exposed from a background thread. Metrics with the same name form a family told apart by
+/// their labels.
+class Registry {
+public:
+    /// @param labels Labels in the exposition format without the braces, e.g., `direction="in"`.
+    Counter& counter(const std::string& name, const std::string& help, std::string labels = {}) {
+        std::lock_guard lock(m_mutex);
+        Counter& counter = m_counters.emplace_back();
+        family(name, help, Type::COUNTER).members.push_back({ std::move(labels), &counter });
+        return counter;
+    }
+
+    Gauge& gauge(const std::string& name, const std::string& help, std::string labels = {}) {
+        std::lock_guard lock(m_mutex);
+        Gauge& gauge = m_gauges.emplace_back();
+        family(name, help, Type::GAUGE).members.push_back({ std::move(labels), &gauge });
+        return gauge;
+    }
+
+    /// @see Histogram::Histogram()
+    Histogram& histogram(const std::string& name,
+                         const std::string& help,
+                         const std::initializer_list<std::uint64_t> bounds,
+                         const double unit,
+                         std::string labels = {}) {
+        std::lock_guard lock(m_mutex);
+        Histogram& histogram = m_histograms.emplace_back(bounds, unit);
+        family(name, help, Type::HISTOGRAM).members.push_back({ std::move(labels), &histogram });
+        return histogram;
+    }
+
+    /// Returns the current values of all the metrics in the Prometheus text format
+    std::string expose() const {
+        std::lock_guard lock(m_mutex);
+        fmt::memory_buffer text;
+        const auto out = std::back_inserter(text);
+        for (const Family& family : m_families) {
+            const char* type = TYPE_NAMES[static_cast<std::size_t>(family.type)];
+            fmt::format_to(out, "# HELP {} {}\n# TYPE {} {}\n", family.name, family.help, family.name, type);
+            for (const Member& member : family.members) {
+                const std::string braced = member.labels.empty() ? "" : "{" + member.labels + "}";
+                if (family.type == Type::COUNTER) {
+                    const auto& counter = *static_cast<const Counter*>(member.metric);
+                    fmt::format_to(out, "{}{} {}\n", family.name, braced, counter.value());
+                } else if (family.type == Type::GAUGE) {
+                    const auto& gauge = *static_cast<const Gauge*>(member.metric);
+                    fmt::format_to(out, "{}{} {}\n", family.name, braced, gauge.value());
+                } else {
+                    const auto& histogram = *static_cast<const Histogram*>(member.metric);
+                    exposeHistogram(text, family.name, member.labels, histogram);
+                }
+            }
+        }
+        return fmt::to_string(text);
+    }
+
+private:
+    enum class Type : std::uint8_t { COUNTER, GAUGE, HISTOGRAM };
+
+    static constexpr const char* TYPE_NAMES[] = { "counter", "gauge", "histogram" };
+
+    struct Member {
+        std::string labels;
+        const void* metric;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<Member> members;
+    };
+
+    static void exposeHistogram(fmt::memory_buffer& text,
+                                const std::string& name,
+                                const std::string& labels,
+                                const Histogram& histogram) {
+        const auto out = std::back_inserter(text);
+        const std::string braced = labels.empty() ? "" : "{" + labels + "}";
+        const std::string prefix = labels.empty() ? "" : labels + ",";
+        std::uint64_t cumulative = 0;
+        for (std::size_t bucket = 0; bucket <= histogram.size(); ++bucket) {
+            cumulative += histogram.count(bucket);
+            std::string le = "+Inf";
+            if (bucket < histogram.size()) {
+                le = fmt::format("{}", static_cast<double>(histogram.bound(bucket)) * histogram.unit());
+            }
+            fmt::format_to(out, "{}_bucket{{{}le=\"{}\"}} {}\n", name, prefix, le, cumulative);
+        }
+        const double sum = static_cast<double>(histogram.sum()) * histogram.unit();
+        fmt::format_to(out, "{}_sum{} {}\n", name, braced, sum);
+        fmt::format_to(out, "{}_count{} {}\n", name, braced, cumulative);
+    }
+
+    Family& family(const std::string& name, const std::string& help, const Type type) {
+        for (Family& family : m_families) {
+            if (family.name == name) {
+                return family;
+            }
+        }
+        return m_families.emplace_back(Family{ name, help, type, {} });
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<Family> m_families;
+    // Deques never move their elements, the references handed out stay valid
+    std::deque<Counter> m_counters;
+    std::deque<Gauge> m_gauges;
+    std::deque<Histogram> m_histograms;
+};
+
+} // namespace example::metrics
+
+#endif // PLUGPP_EXAMPLE_METRICS_METRICS_H
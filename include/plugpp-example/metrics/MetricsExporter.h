@@ -0,0 +1,159 @@
+#ifndef PLUGPP_EXAMPLE_METRICS_METRICSEXPORTER_H
+#define PLUGPP_EXAMPLE_METRICS_METRICSEXPORTER_H
+
+#include "plugpp-example/io/log.h"
+#include "plugpp-example/metrics/Metrics.h"
+
+#include <spdlog/spdlog.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace example::metrics {
+
+/// Periodically writes the metrics of a registry out for a local scraper, on a background thread
+///
+/// The target is either a file, which is written as a temporary file renamed into place so the scraper never
+/// reads half of a snapshot, or a UNIX stream socket given as `unix:<path>` the snapshot is sent to, one
+/// connection per snapshot. An empty target disables the export.
+class MetricsExporter {
+public:
+    static constexpr std::string_view SOCKET_PREFIX = "unix:";
+
+    struct Stats {
+        std::uint64_t written;
+        std::uint64_t failed;
+    };
+
+    explicit MetricsExporter(const Registry& registry)
+        : m_registry(registry)
+        , m_thread([this] { run(); }) {}
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    ~MetricsExporter() noexcept {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    /// Sets where and how often the metrics are written, the next snapshot is written right away on a change
+    /// @param intervalMs Milliseconds between the snapshots, at least 100.
+    void configure(std::string target, const int intervalMs) {
+        {
+            std::lock_guard lock(m_mutex);
+            const auto interval = std::chrono::milliseconds(std::max(intervalMs, 100));
+            if (target == m_target && interval == m_interval) {
+                return;
+            }
+            m_target = std::move(target);
+            m_interval = interval;
+        }
+        m_cv.notify_all();
+    }
+
+    Stats stats() const {
+        return { m_written.load(std::memory_order_relaxed), m_failed.load(std::memory_order_relaxed) };
+    }
+
+private:
+    void run() {
+        std::unique_lock lock(m_mutex);
+        while (!m_stopping) {
+            const std::string target = m_target;
+            const auto interval = m_interval;
+            if (!target.empty()) {
+                lock.unlock();
+                const bool written = write(target, m_registry.expose());
+                (written ? m_written : m_failed).fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+            }
+            // Woken up early by a new configuration or the destructor
+            m_cv.wait_for(lock, interval, [&] {
+                return m_stopping || m_target != target || m_interval != interval;
+            });
+        }
+    }
+
+    static bool write(const std::string& target, const std::string& text) {
+        if (target.compare(0, SOCKET_PREFIX.size(), SOCKET_PREFIX) == 0) {
+            return send(target.substr(SOCKET_PREFIX.size()), text);
+        }
+        const std::string temporary = target + ".tmp";
+        std::FILE* file = std::fopen(temporary.c_str(), "w");
+        bool written = file && std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        written = file && std::fclose(file) == 0 && written;
+        if (!written || std::rename(temporary.c_str(), target.c_str()) != 0) {
+            const int error = errno;
+            EXAMPLE_LOG_RATE_LIMITED(
+                warn, 1, 60 * 1000, "Can't write the metrics to '{}': {}", target, std::strerror(error));
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    static bool send(const std::string& path, const std::string& text) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            EXAMPLE_LOG_RATE_LIMITED(warn, 1, 60 * 1000, "Metrics socket path '{}' is too long", path);
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const auto* peer = reinterpret_cast<const sockaddr*>(&address);
+        bool sent = fd >= 0 && ::connect(fd, peer, sizeof(address)) == 0;
+        for (std::size_t offset = 0; sent && offset < text.size();) {
+            const ssize_t n = ::send(fd, text.data() + offset, text.size() - offset, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            sent = n > 0;
+            offset += sent ? static_cast<std::size_t>(n) : 0;
+        }
+        const int error = errno;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (!sent) {
+            EXAMPLE_LOG_RATE_LIMITED(
+                warn, 1, 60 * 1000, "Can't send the metrics to '{}': {}", path, std::strerror(error));
+        }
+        return sent;
+    }
+
+    const Registry& m_registry;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::string m_target;
+    std::chrono::milliseconds m_interval{ 1000 };
+    bool m_stopping = false;
+    std::atomic<std::uint64_t> m_written{ 0 };
+    std::atomic<std::uint64_t> m_failed{ 0 };
+
+    // Declared last so the thread starts once the rest of the members is initialized
+    std::thread m_thread;
+};
+
+} // namespace example::metrics
+
+#endif // PLUGPP_EXAMPLE_METRICS_METRICSEXPORTER_H
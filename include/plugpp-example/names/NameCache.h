@@ -0,0 +1,105 @@
+#ifndef PLUGPP_EXAMPLE_NAMES_NAMECACHE_H
+#define PLUGPP_EXAMPLE_NAMES_NAMECACHE_H
+
+#include "plugpp-example/names/NameKernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace example::names {
+
+/// Colour-stripped and normalized names of the players, per slot
+///
+/// The names are only worked on when they change, every log line and message gets a view of the cached
+/// name instead of stripping a copy of it. The normalized names are hashed, so the players whose names
+/// pass for each other are found by comparing 64 integers.
+class NameCache {
+public:
+    static constexpr std::size_t SLOTS = 64;
+    static constexpr std::size_t MAX_LENGTH = 32; ///< Of the userinfo's name, the rest is cut off.
+
+    /// Updates the name of the slot
+    /// @returns true if the name changed.
+    bool update(const int slot, std::string_view raw) {
+        if (!valid(slot)) {
+            return false;
+        }
+        raw = raw.substr(0, MAX_LENGTH);
+        if (m_lengths[slot].raw == raw.size() && std::memcmp(m_raw[slot], raw.data(), raw.size()) == 0) {
+            return false;
+        }
+        ++m_updates;
+        std::memcpy(m_raw[slot], raw.data(), raw.size());
+        m_lengths[slot].raw = static_cast<std::uint8_t>(raw.size());
+        const std::size_t length = stripColors(raw, m_names[slot]);
+        m_lengths[slot].name = static_cast<std::uint8_t>(length);
+        const std::size_t keyLength = normalize({ m_names[slot], length }, m_keys[slot]);
+        m_lengths[slot].key = static_cast<std::uint8_t>(keyLength);
+        m_keyHashes[slot] = keyLength == 0 ? 0 : hash({ m_keys[slot], keyLength });
+        return true;
+    }
+
+    void reset(const int slot) {
+        if (valid(slot)) {
+            m_lengths[slot] = {};
+            m_keyHashes[slot] = 0;
+        }
+    }
+
+    /// Returns the name without the colour codes, empty for unknown slots
+    std::string_view name(const int slot) const {
+        return valid(slot) ? std::string_view(m_names[slot], m_lengths[slot].name) : std::string_view();
+    }
+
+    /// Returns the normalized name, see @ref normalize()
+    std::string_view key(const int slot) const {
+        return valid(slot) ? std::string_view(m_keys[slot], m_lengths[slot].key) : std::string_view();
+    }
+
+    /// Returns the first other slot with a name passing for the slot's one or -1 if there's none
+    int findClash(const int slot) const {
+        if (!valid(slot) || m_keyHashes[slot] == 0) {
+            return -1;
+        }
+        for (int other = 0; other < static_cast<int>(SLOTS); ++other) {
+            if (other != slot && m_keyHashes[other] == m_keyHashes[slot] && key(other) == key(slot)) {
+                return other;
+            }
+        }
+        return -1;
+    }
+
+    /// Returns the number of times a name was stripped and normalized
+    std::uint64_t updates() const { return m_updates; }
+
+    static bool valid(const int slot) { return slot >= 0 && static_cast<std::size_t>(slot) < SLOTS; }
+
+private:
+    struct Lengths {
+        std::uint8_t raw;
+        std::uint8_t name;
+        std::uint8_t key;
+    };
+
+    /// FNV-1a, never 0 so 0 can mark the slots without a name
+    static std::uint64_t hash(const std::string_view key) {
+        std::uint64_t h = 0xCBF29CE484222325ULL;
+        for (const char c : key) {
+            h = (h ^ static_cast<std::uint8_t>(c)) * 0x100000001B3ULL;
+        }
+        return std::max<std::uint64_t>(h, 1);
+    }
+
+    std::uint64_t m_keyHashes[SLOTS] = {};
+    Lengths m_lengths[SLOTS] = {};
+    char m_raw[SLOTS][MAX_LENGTH];
+    char m_names[SLOTS][MAX_LENGTH];
+    char m_keys[SLOTS][MAX_LENGTH];
+    std::uint64_t m_updates = 0;
+};
+
+} // namespace example::names
+
+#endif // PLUGPP_EXAMPLE_NAMES_NAMECACHE_H
@@ -0,0 +1,133 @@
+#ifndef PLUGPP_EXAMPLE_NAMES_NAMEKERNELS_H
+#define PLUGPP_EXAMPLE_NAMES_NAMEKERNELS_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/// Colour stripping and normalization of player names
+///
+/// The colour codes are found eight bytes at a time in a 64-bit word (SWAR) - the plugin is built for 32-bit
+/// x86 where SSE2 isn't guaranteed, and most names have a colour code or two at most, so the words without
+/// any are copied as they are and only the bytes around a caret are looked at one by one.
+///
+/// This header has no dependencies on the server's API.
+namespace example::names {
+
+namespace detail {
+
+    constexpr std::uint64_t ONES = 0x0101010101010101ULL;
+    constexpr std::uint64_t HIGHS = 0x8080808080808080ULL;
+
+    /// Returns the high bit of every byte of the word equal to the byte, the lowest one is exact
+    inline std::uint64_t findByte(const std::uint64_t word, const std::uint8_t byte) {
+        const std::uint64_t x = word ^ (ONES * byte);
+        return (x - ONES) & ~x & HIGHS;
+    }
+
+    inline bool isColorCode(const char* p, const char* end) {
+        return p[0] == '^' && p + 1 < end && p[1] >= '0' && p[1] <= '9';
+    }
+
+    /// Maps every byte to the lowercase letter it can pass for, 0 for the bytes ignored in names
+    constexpr std::array<char, 256> makeConfusables() {
+        std::array<char, 256> map{};
+        for (int c = 'a'; c <= 'z'; ++c) {
+            map[c] = static_cast<char>(c);
+            map[c - 'a' + 'A'] = static_cast<char>(c);
+        }
+        constexpr std::string_view FROM = "0134567892@$|!+";
+        constexpr std::string_view TO = "oleastbgzaslllt";
+        for (std::size_t i = 0; i < FROM.size(); ++i) {
+            map[static_cast<std::uint8_t>(FROM[i])] = TO[i];
+        }
+        // A lowercase i, an uppercase I, a 1 and an l are all a thin stroke at the game's font sizes, a name
+        // swapping any of them (e.g., "Adm1n" for "Admin") passes for the original
+        map['i'] = 'l';
+        map['I'] = 'l';
+        // Bytes above ASCII stay as they are, they're not confusable with anything typed on a US keyboard
+        for (int c = 0x80; c < 0x100; ++c) {
+            map[c] = static_cast<char>(c);
+        }
+        return map;
+    }
+
+    constexpr std::array<char, 256> CONFUSABLES = makeConfusables();
+
+} // namespace detail
+
+/// Copies the name without the colour codes (a caret followed by a digit)
+/// @param out Buffer of at least the size of the name.
+/// @returns The length of the stripped name.
+inline std::size_t stripColors(const std::string_view name, char* out) {
+    const char* in = name.data();
+    const char* const end = in + name.size();
+    char* const begin = out;
+    while (in < end) {
+        if (end - in >= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, in, sizeof(word));
+            const std::uint64_t carets = detail::findByte(word, '^');
+            if (carets == 0) {
+                std::memcpy(out, in, sizeof(word));
+                in += sizeof(word);
+                out += sizeof(word);
+                continue;
+            }
+            // Bytes up to the first caret (the lowest bit is exact, little endian)
+            const auto plain = static_cast<std::size_t>(__builtin_ctzll(carets) / 8);
+            std::memcpy(out, in, plain);
+            in += plain;
+            out += plain;
+        }
+        if (detail::isColorCode(in, end)) {
+            in += 2;
+        } else {
+            *out++ = *in++;
+        }
+    }
+    return static_cast<std::size_t>(out - begin);
+}
+
+/// Reduces a colour-stripped name to what it looks like, so names passing for each other are equal
+///
+/// Letters are lowercased and digits and symbols which can pass for letters are replaced by them ("Adm1n" and
+/// "ADMlN" both become "admln"), "rn" becomes "m" and "vv" becomes "w". Spaces and the remaining punctuation
+/// are dropped.
+/// @param out Buffer of at least the size of the name.
+/// @returns The length of the normalized name.
+inline std::size_t normalize(const std::string_view name, char* out) {
+    std::size_t length = 0;
+    for (const char c : name) {
+        const char mapped = detail::CONFUSABLES[static_cast<std::uint8_t>(c)];
+        if (mapped == 0) {
+            continue;
+        }
+        const char previous = length > 0 ? out[length - 1] : '\0';
+        if ((previous == 'r' && mapped == 'n') || (previous == 'v' && mapped == 'v')) {
+            out[length - 1] = mapped == 'n' ? 'm' : 'w';
+            continue;
+        }
+        out[length++] = mapped;
+    }
+    return length;
+}
+
+/// A colour-stripped copy of a fixed-size name, e.g., of a @ref baninfo_t, without allocating
+template <std::size_t N>
+class StrippedName {
+public:
+    explicit StrippedName(const char (&name)[N])
+        : m_length(stripColors(std::string_view(name, strnlen(name, N)), m_text)) {}
+
+    operator std::string_view() const { return { m_text, m_length }; }
+
+private:
+    char m_text[N];
+    std::size_t m_length;
+};
+
+} // namespace example::names
+
+#endif // PLUGPP_EXAMPLE_NAMES_NAMEKERNELS_H
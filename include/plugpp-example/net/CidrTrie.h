@@ -0,0 +1,452 @@
+#ifndef PLUGPP_EXAMPLE_NET_CIDRTRIE_H
+#define PLUGPP_EXAMPLE_NET_CIDRTRIE_H
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace example::net {
+
+/// What a range of addresses is allowed to do
+enum class IpAction : std::uint8_t {
+    NONE,     ///< No rule covers the address.
+    ALLOW,    ///< Overrides a deny rule of a shorter prefix.
+    DENY,     ///< Can't connect, its connectionless packets are dropped.
+    RESERVED, ///< May join the reserved slots.
+    COUNT,
+};
+
+constexpr std::string_view IP_ACTION_NAMES[] = { "none", "allow", "deny", "reserved" };
+static_assert(std::size(IP_ACTION_NAMES) == static_cast<std::size_t>(IpAction::COUNT));
+
+/// An IPv6 address as a 128-bit number, IPv4 addresses are mapped into ::ffff:0:0/96
+struct IpKey {
+    std::uint64_t hi;
+    std::uint64_t lo;
+};
+
+/// A range of addresses and its action
+struct IpRule {
+    IpKey key;
+    std::uint8_t length; ///< Prefix length in bits, 0 - 128.
+    IpAction action;
+};
+
+namespace detail {
+
+    constexpr std::uint32_t KEY_BITS = 128;
+    constexpr std::uint32_t IPV4_MAPPED_BITS = 96;
+
+    inline std::uint64_t highBits(const std::uint32_t bits) {
+        return bits == 0 ? 0 : bits >= 64 ? ~std::uint64_t{ 0 } : ~std::uint64_t{ 0 } << (64 - bits);
+    }
+
+    /// Clears all the bits of the key after the prefix
+    inline IpKey mask(const IpKey& key, const std::uint32_t length) {
+        return { key.hi & highBits(length), key.lo & highBits(length > 64 ? length - 64 : 0) };
+    }
+
+    inline std::uint32_t bit(const IpKey& key, const std::uint32_t i) {
+        return static_cast<std::uint32_t>(i < 64 ? key.hi >> (63 - i) : key.lo >> (127 - i)) & 1;
+    }
+
+    /// Returns the number of leading bits the keys have in common
+    inline std::uint32_t commonLength(const IpKey& a, const IpKey& b) {
+        if (const std::uint64_t diff = a.hi ^ b.hi; diff != 0) {
+            return static_cast<std::uint32_t>(__builtin_clzll(diff));
+        }
+        if (const std::uint64_t diff = a.lo ^ b.lo; diff != 0) {
+            return 64 + static_cast<std::uint32_t>(__builtin_clzll(diff));
+        }
+        return KEY_BITS;
+    }
+
+    inline std::uint64_t readBigEndian(const std::uint8_t* bytes) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value = value << 8 | bytes[i];
+        }
+        return value;
+    }
+
+} // namespace detail
+
+/// Returns the key of an IPv4 address in the network byte order
+inline IpKey toIpKey4(const std::uint8_t* ip) {
+    return { 0, std::uint64_t{ 0xffff } << 32 | std::uint64_t{ ip[0] } << 24 | std::uint64_t{ ip[1] } << 16 |
+                    std::uint64_t{ ip[2] } << 8 | ip[3] };
+}
+
+/// Returns the key of an IPv6 address in the network byte order
+inline IpKey toIpKey6(const std::uint8_t* ip) {
+    return { detail::readBigEndian(ip), detail::readBigEndian(ip + 8) };
+}
+
+/// Parses a rule of the form `<allow|deny|reserved> <address>[/<prefix length>]`
+/// @returns false if the line isn't a valid rule.
+inline bool parseIpRule(std::string_view line, IpRule& rule) {
+    const auto trim = [](std::string_view text) {
+        const std::size_t first = text.find_first_not_of(" \t\r");
+        const std::size_t last = text.find_last_not_of(" \t\r");
+        return first == std::string_view::npos ? std::string_view() : text.substr(first, last - first + 1);
+    };
+    line = trim(line);
+    const std::size_t space = line.find_first_of(" \t");
+    if (space == std::string_view::npos) {
+        return false;
+    }
+    const std::string_view action = line.substr(0, space);
+    std::string_view range = trim(line.substr(space));
+
+    rule.action = IpAction::NONE;
+    for (std::size_t i = 1; i < std::size(IP_ACTION_NAMES); ++i) {
+        if (action == IP_ACTION_NAMES[i]) {
+            rule.action = static_cast<IpAction>(i);
+        }
+    }
+    if (rule.action == IpAction::NONE) {
+        return false;
+    }
+
+    int length = -1;
+    if (const std::size_t slash = range.find('/'); slash != std::string_view::npos) {
+        const std::string_view digits = range.substr(slash + 1);
+        if (digits.empty() || digits.size() > 3 || digits.find_first_not_of("0123456789") != digits.npos) {
+            return false;
+        }
+        length = std::stoi(std::string(digits));
+        range = range.substr(0, slash);
+    }
+    if (range.size() >= INET6_ADDRSTRLEN) {
+        return false;
+    }
+    char text[INET6_ADDRSTRLEN];
+    std::memcpy(text, range.data(), range.size());
+    text[range.size()] = '\0';
+
+    std::uint8_t ip[16];
+    if (::inet_pton(AF_INET, text, ip) == 1) {
+        if (length > 32) {
+            return false;
+        }
+        rule.key = toIpKey4(ip);
+        rule.length = static_cast<std::uint8_t>(detail::IPV4_MAPPED_BITS + (length < 0 ? 32 : length));
+    } else if (::inet_pton(AF_INET6, text, ip) == 1) {
+        if (length > 128) {
+            return false;
+        }
+        rule.key = toIpKey6(ip);
+        rule.length = static_cast<std::uint8_t>(length < 0 ? 128 : length);
+    } else {
+        return false;
+    }
+    rule.key = detail::mask(rule.key, rule.length);
+    return true;
+}
+
+/// Longest-prefix-match table of address ranges
+///
+/// The ranges are stored in a path-compressed binary trie - every node holds a whole prefix, so a lookup
+/// visits only the nodes where the covering prefixes branch, at most one per bit of the address, and the
+/// most specific rule covering the address wins.
+///
+/// The trie is a flat array of nodes linked by indices, so it's saved into a file as is and loaded by
+/// mmap'ing the file, without rebuilding anything. @ref fromFile() compiles a text list of rules into such a
+/// file next to it and reuses it until the list changes.
+class CidrTrie {
+public:
+    struct Node {
+        std::uint64_t hi;
+        std::uint64_t lo;
+        std::uint32_t child[2];
+        std::uint8_t length;
+        IpAction action;
+        std::uint8_t reserved[6];
+    };
+    static_assert(sizeof(Node) == 32);
+
+    static constexpr std::uint32_t NIL = 0xffffffff;
+
+    /// Builds the trie, later rules of the same range override the earlier ones
+    explicit CidrTrie(const std::vector<IpRule>& rules)
+        : m_rules(rules.size()) {
+        m_owned.reserve(rules.size() * 2);
+        for (const IpRule& rule : rules) {
+            insert(rule);
+        }
+        m_nodes = m_owned.data();
+        m_size = m_owned.size();
+    }
+
+    CidrTrie(const CidrTrie&) = delete;
+    CidrTrie& operator=(const CidrTrie&) = delete;
+
+    ~CidrTrie() noexcept {
+        if (m_mapping) {
+            ::munmap(m_mapping, m_mappingSize);
+        }
+    }
+
+    /// Loads the trie compiled from the list of rules
+    ///
+    /// The list has a rule per line (see @ref parseIpRule()), empty lines and lines starting with `#` are
+    /// skipped. The compiled trie is stored into `<path>.bin` and mapped from there, until the list changes.
+    static std::unique_ptr<CidrTrie> fromFile(const std::string& path) {
+        struct stat st {};
+        if (::stat(path.c_str(), &st) != 0) {
+            throw std::runtime_error("Can't open the IP list '" + path + "'");
+        }
+        const Source source{ static_cast<std::uint64_t>(st.st_size),
+                             static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec };
+        const std::string binPath = path + ".bin";
+        if (auto trie = map(binPath, source)) {
+            return trie;
+        }
+
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("Can't open the IP list '" + path + "'");
+        }
+        std::vector<IpRule> rules;
+        std::size_t invalid = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line.front() == '#' || line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            IpRule rule;
+            if (parseIpRule(line, rule)) {
+                rules.push_back(rule);
+            } else {
+                ++invalid;
+            }
+        }
+
+        auto trie = std::make_unique<CidrTrie>(rules);
+        trie->m_invalid = invalid;
+        if (trie->save(binPath, source)) {
+            if (auto mapped = map(binPath, source)) {
+                return mapped;
+            }
+        }
+        return trie;
+    }
+
+    /// Returns the action of the most specific range covering the address
+    IpAction lookup(const IpKey& key) const {
+        IpAction action = IpAction::NONE;
+        std::uint32_t index = m_root;
+        while (index != NIL) {
+            const Node& node = m_nodes[index];
+            const IpKey prefix = detail::mask(key, node.length);
+            if (prefix.hi != node.hi || prefix.lo != node.lo) {
+                break;
+            }
+            action = node.action != IpAction::NONE ? node.action : action;
+            if (node.length == detail::KEY_BITS) {
+                break;
+            }
+            index = node.child[detail::bit(key, node.length)];
+        }
+        return action;
+    }
+
+    std::size_t rules() const { return m_rules; }
+    std::size_t nodes() const { return m_size; }
+    std::size_t invalid() const { return m_invalid; }
+    bool mapped() const { return m_mapping != nullptr; }
+
+private:
+    /// Identifies the version of the list the trie was compiled from
+    struct Source {
+        std::uint64_t size;
+        std::int64_t mtime; ///< Nanoseconds.
+    };
+
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t nodes;
+        std::uint32_t root;
+        std::uint32_t rules;
+        std::uint32_t invalid;
+        std::uint32_t reserved;
+        std::uint64_t sourceSize;
+        std::int64_t sourceMtime;
+    };
+    static_assert(sizeof(FileHeader) == 48);
+
+    static constexpr char FILE_MAGIC[8] = { 'P', 'P', 'X', 'C', 'I', 'D', 'R', '\0' };
+    static constexpr std::uint32_t VERSION = 1;
+
+    CidrTrie() = default;
+
+    std::uint32_t addNode(const IpKey& key, const std::uint32_t length, const IpAction action) {
+        Node node{};
+        node.hi = key.hi;
+        node.lo = key.lo;
+        node.child[0] = NIL;
+        node.child[1] = NIL;
+        node.length = static_cast<std::uint8_t>(length);
+        node.action = action;
+        m_owned.push_back(node);
+        return static_cast<std::uint32_t>(m_owned.size() - 1);
+    }
+
+    void insert(const IpRule& rule) {
+        const IpKey key = detail::mask(rule.key, rule.length);
+        const std::uint32_t length = rule.length;
+
+        // The link pointing to the current node, re-evaluated as adding nodes may move them
+        std::uint32_t parent = NIL;
+        std::uint32_t side = 0;
+        const auto link = [&]() -> std::uint32_t& {
+            return parent == NIL ? m_root : m_owned[parent].child[side];
+        };
+
+        for (std::uint32_t index = m_root;;) {
+            if (index == NIL) {
+                const std::uint32_t leaf = addNode(key, length, rule.action);
+                link() = leaf;
+                return;
+            }
+            const Node node = m_owned[index];
+            const IpKey nodeKey{ node.hi, node.lo };
+            const std::uint32_t common =
+                std::min({ detail::commonLength(key, nodeKey), length, std::uint32_t{ node.length } });
+            if (common == node.length) {
+                if (length == node.length) {
+                    m_owned[index].action = rule.action;
+                    return;
+                }
+                parent = index;
+                side = detail::bit(key, node.length);
+                index = node.child[side];
+                continue;
+            }
+
+            if (common == length) {
+                // The rule's range contains the node's range
+                const std::uint32_t inner = addNode(key, length, rule.action);
+                m_owned[inner].child[detail::bit(nodeKey, common)] = index;
+                link() = inner;
+            } else {
+                // The ranges diverge, a branch without an action joins them
+                const std::uint32_t branch = addNode(detail::mask(key, common), common, IpAction::NONE);
+                const std::uint32_t leaf = addNode(key, length, rule.action);
+                m_owned[branch].child[detail::bit(key, common)] = leaf;
+                m_owned[branch].child[detail::bit(nodeKey, common)] = index;
+                link() = branch;
+            }
+            return;
+        }
+    }
+
+    /// Writes the trie into a temporary file and renames it over the path
+    bool save(const std::string& path, const Source& source) const {
+        FileHeader header{};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = VERSION;
+        header.nodes = static_cast<std::uint32_t>(m_size);
+        header.root = m_root;
+        header.rules = static_cast<std::uint32_t>(m_rules);
+        header.invalid = static_cast<std::uint32_t>(m_invalid);
+        header.sourceSize = source.size;
+        header.sourceMtime = source.mtime;
+
+        const std::string temporary = path + ".tmp";
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                       std::fwrite(m_nodes, sizeof(Node), m_size, file) == m_size;
+        written = std::fclose(file) == 0 && written;
+        if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /// Maps the compiled trie, if it's valid and compiled from the given version of the list
+    static std::unique_ptr<CidrTrie> map(const std::string& path, const Source& source) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            return nullptr;
+        }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+
+        std::unique_ptr<CidrTrie> trie(new CidrTrie());
+        trie->m_mapping = data;
+        trie->m_mappingSize = size;
+
+        FileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != VERSION ||
+            header.sourceSize != source.size || header.sourceMtime != source.mtime ||
+            size != sizeof(FileHeader) + std::size_t{ header.nodes } * sizeof(Node)) {
+            return nullptr;
+        }
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        trie->m_nodes = reinterpret_cast<const Node*>(bytes + sizeof(header));
+        trie->m_size = header.nodes;
+        trie->m_root = header.root;
+        trie->m_rules = header.rules;
+        trie->m_invalid = header.invalid;
+
+        // A damaged file must not send a lookup out of the mapping or into a cycle
+        const auto validIndex = [&](const std::uint32_t index) {
+            return index == NIL || index < header.nodes;
+        };
+        if (!validIndex(trie->m_root)) {
+            return nullptr;
+        }
+        for (std::size_t i = 0; i < trie->m_size; ++i) {
+            const Node& node = trie->m_nodes[i];
+            for (const std::uint32_t child : node.child) {
+                if (!validIndex(child) || (child != NIL && trie->m_nodes[child].length <= node.length)) {
+                    return nullptr;
+                }
+            }
+        }
+        return trie;
+    }
+
+    const Node* m_nodes = nullptr;
+    std::size_t m_size = 0;
+    std::uint32_t m_root = NIL;
+    std::size_t m_rules = 0;
+    std::size_t m_invalid = 0;
+    std::vector<Node> m_owned;
+    void* m_mapping = nullptr;
+    std::size_t m_mappingSize = 0;
+};
+
+} // namespace example::net
+
+#endif // PLUGPP_EXAMPLE_NET_CIDRTRIE_H
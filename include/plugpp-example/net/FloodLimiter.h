@@ -0,0 +1,333 @@
+#ifndef PLUGPP_EXAMPLE_NET_FLOODLIMITER_H
+#define PLUGPP_EXAMPLE_NET_FLOODLIMITER_H
+
+#include "plugpp-example/state/StateSnapshot.h"
+#include "plugpp-example/state/StateWriter.h"
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+namespace example::net {
+
+/// Kind of a connectionless (out-of-band) packet
+enum class PacketClass : std::uint8_t {
+    QUERY,   ///< getstatus, getinfo
+    CONNECT, ///< getchallenge, connect
+    OTHER,   ///< rcon and everything else
+    COUNT,
+    IN_GAME = COUNT, ///< Sequenced packet of an established connection, never limited.
+};
+
+/// Rate of a token bucket
+struct RateLimit {
+    int rate;  ///< Packets per second.
+    int burst; ///< Packets allowed in a burst.
+};
+
+/// Per-IP token-bucket limiter for connectionless packets
+///
+/// The buckets live in a fixed-size open-addressing table of cache-line-sized entries, so a decision is a
+/// hash, a few compares within a couple of cache lines and never allocates. When the probed window is full,
+/// an entry is evicted using the clock (second chance) algorithm.
+class FloodLimiter {
+public:
+    static constexpr std::size_t CAPACITY = 4096;
+    static constexpr std::size_t PROBE_LIMIT = 8;
+
+    struct Stats {
+        std::uint64_t passed;
+        std::uint64_t dropped[static_cast<std::size_t>(PacketClass::COUNT)];
+        std::uint64_t evictions;
+        std::uint64_t throttledReplies; ///< Queries dropped because of the reply limit.
+    };
+
+    struct alignas(64) Entry {
+        std::uint32_t tag; ///< Hash of the address, 0 for an empty entry.
+        std::uint32_t lastSeen;
+        std::uint64_t address[2];
+        std::int32_t tokens[static_cast<std::size_t>(PacketClass::COUNT)]; ///< In thousandths of a token.
+        std::int32_t replyTokens; ///< Bytes of replies in thousandths, negative when in debt.
+        std::uint8_t type;
+        std::uint8_t referenced;
+    };
+    static_assert(sizeof(Entry) == 64);
+
+    /// The complete state of the limiter, trivially copyable
+    struct State {
+        Entry entries[CAPACITY];
+        Stats stats;
+    };
+    static_assert(std::is_trivially_copyable_v<State>);
+
+    /// Layout version of @ref State, shall be bumped whenever the structure changes
+    static constexpr std::uint32_t STATE_VERSION = 2;
+
+    /// Classifies the packet by its content
+    static PacketClass classify(const void* data, const int size) {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        if (size < 4 || bytes[0] != 0xFF || bytes[1] != 0xFF || bytes[2] != 0xFF || bytes[3] != 0xFF) {
+            return PacketClass::IN_GAME;
+        }
+        const std::string_view command(reinterpret_cast<const char*>(bytes + 4),
+                                       static_cast<std::size_t>(size - 4));
+        if (startsWith(command, "getstatus") || startsWith(command, "getinfo")) {
+            return PacketClass::QUERY;
+        }
+        if (startsWith(command, "getchallenge") || startsWith(command, "connect")) {
+            return PacketClass::CONNECT;
+        }
+        return PacketClass::OTHER;
+    }
+
+    /// Sets the rate of the given packet class, a rate of 0 disables the limit
+    void setLimit(const PacketClass packetClass, const RateLimit limit) {
+        m_limits[static_cast<std::size_t>(packetClass)] = limit;
+    }
+
+    /// Sets the rate of the connectionless replies in bytes, a rate of 0 disables the limit
+    ///
+    /// Queries are small and their replies big, so a forged source address turns the server into an
+    /// amplifier. Limiting the bytes sent to every address caps what an attacker gets out of it.
+    void setReplyLimit(const RateLimit limit) {
+        m_replyLimit = limit;
+        if (m_seedReplies && limit.rate > 0) {
+            // The buckets restored from the records were created before the limit was known
+            m_seedReplies = false;
+            for (Entry& entry : m_state->entries) {
+                if (entry.tag != 0) {
+                    entry.replyTokens = limit.burst * TOKEN;
+                }
+            }
+        }
+    }
+
+    /// Sets the current time in milliseconds
+    ///
+    /// Expected to be called once per server frame, the frame granularity is plenty for the limits.
+    void setTime(const int now) { m_now = static_cast<std::uint32_t>(now); }
+
+    /// Charges the sender of the packet one token
+    /// @returns true if the packet should pass, false if it should be dropped.
+    bool allow(const netadr_t& from, const PacketClass packetClass) {
+        if (packetClass == PacketClass::IN_GAME || (from.type != NA_IP && from.type != NA_IP6)) {
+            return true;
+        }
+        const auto index = static_cast<std::size_t>(packetClass);
+        if (m_limits[index].rate <= 0) {
+            ++m_state->stats.passed;
+            return true;
+        }
+        Entry& entry = find(from);
+        refill(entry);
+        if (entry.tokens[index] < TOKEN) {
+            ++m_state->stats.dropped[index];
+            return false;
+        }
+        entry.tokens[index] -= TOKEN;
+        ++m_state->stats.passed;
+        return true;
+    }
+
+    /// Checks if the sender of a query may get a reply, the replies already sent to it are charged by
+    /// @ref chargeReply()
+    /// @returns false if the query should be dropped.
+    bool mayReply(const netadr_t& to) {
+        if (m_replyLimit.rate <= 0 || (to.type != NA_IP && to.type != NA_IP6)) {
+            return true;
+        }
+        Entry& entry = find(to);
+        refill(entry);
+        if (entry.replyTokens <= 0) {
+            ++m_state->stats.throttledReplies;
+            return false;
+        }
+        return true;
+    }
+
+    /// Charges the receiver for the bytes of a connectionless reply, it may go into debt
+    void chargeReply(const netadr_t& to, const int bytes) {
+        if (m_replyLimit.rate <= 0 || (to.type != NA_IP && to.type != NA_IP6)) {
+            return;
+        }
+        Entry& entry = find(to);
+        refill(entry);
+        entry.replyTokens = saturate(std::int64_t{ entry.replyTokens } - std::int64_t{ bytes } * TOKEN);
+    }
+
+    const Stats& stats() const { return m_state->stats; }
+
+    /// Stores the buckets for the next instance of the plugin
+    void save(state::StateWriter& writer) const {
+        writer.addPod(state::SectionId::FLOOD_LIMITER, STATE_VERSION, *m_state);
+        state::RecordWriter records;
+        records.add(STATS_RECORD, m_state->stats);
+        for (const Entry& entry : m_state->entries) {
+            if (entry.tag != 0) {
+                records.add(BUCKET_RECORD,
+                            Bucket{ { entry.address[0], entry.address[1] },
+                                    { entry.tokens[0], entry.tokens[1], entry.tokens[2] },
+                                    entry.lastSeen,
+                                    entry.type });
+            }
+        }
+        writer.addRecords(state::SectionId::FLOOD_LIMITER, RECORDS_VERSION, records);
+    }
+
+    /// Continues with the buckets of the previous instance of the plugin
+    ///
+    /// The state is used in place when its layout didn't change, otherwise the buckets are inserted anew and
+    /// get a full reply budget once the reply limit is set.
+    void restore(state::StateSnapshot& snapshot) {
+        if (State* state = snapshot.adopt<State>(state::SectionId::FLOOD_LIMITER, STATE_VERSION)) {
+            m_state.adopt(*state);
+            return;
+        }
+        m_seedReplies = true;
+        snapshot.forEachRecord(
+            state::SectionId::FLOOD_LIMITER, RECORDS_VERSION, [this](const state::Record& record) {
+                Bucket bucket;
+                if (record.tag == STATS_RECORD) {
+                    record.read(m_state->stats);
+                } else if (record.tag == BUCKET_RECORD && record.read(bucket)) {
+                    Entry& entry = find(bucket.address, bucket.type);
+                    std::memcpy(entry.tokens, bucket.tokens, sizeof(entry.tokens));
+                    entry.lastSeen = bucket.lastSeen;
+                }
+            });
+    }
+
+private:
+    static constexpr std::int32_t TOKEN = 1000;
+    static constexpr std::uint32_t MAX_REFILL_MS = 60000;
+
+    /// Version of the records written by @ref save(), independent of the layout of @ref State
+    static constexpr std::uint32_t RECORDS_VERSION = 1;
+
+    enum : std::uint32_t {
+        STATS_RECORD = 1, ///< Stats
+        BUCKET_RECORD,    ///< Bucket
+    };
+
+    struct Bucket {
+        std::uint64_t address[2];
+        std::int32_t tokens[3];
+        std::uint32_t lastSeen;
+        std::uint8_t type;
+    };
+    static_assert(sizeof(Bucket::tokens) == sizeof(Entry::tokens));
+
+    static bool startsWith(const std::string_view text, const std::string_view prefix) {
+        if (text.size() < prefix.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < prefix.size(); ++i) {
+            if ((text[i] | 0x20) != prefix[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void getKey(const netadr_t& address, std::uint64_t (&key)[2]) {
+        key[0] = 0;
+        key[1] = 0;
+        if (address.type == NA_IP6) {
+            std::memcpy(key, address.ip6, sizeof(address.ip6));
+        } else {
+            std::memcpy(key, address.ip, sizeof(address.ip));
+        }
+    }
+
+    /// Adds the tokens earned since the entry was last seen
+    void refill(Entry& entry) {
+        const std::uint32_t elapsed = std::min<std::uint32_t>(m_now - entry.lastSeen, MAX_REFILL_MS);
+        entry.lastSeen = m_now;
+        entry.referenced = 1;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(PacketClass::COUNT); ++i) {
+            const std::int32_t refill = static_cast<std::int32_t>(elapsed) * m_limits[i].rate;
+            entry.tokens[i] = std::min(entry.tokens[i] + refill, m_limits[i].burst * TOKEN);
+        }
+        const std::int64_t replyTokens =
+            std::int64_t{ entry.replyTokens } + std::int64_t{ elapsed } * m_replyLimit.rate;
+        entry.replyTokens = saturate(std::min(replyTokens, std::int64_t{ m_replyLimit.burst } * TOKEN));
+    }
+
+    static std::int32_t saturate(const std::int64_t tokens) {
+        return static_cast<std::int32_t>(std::clamp<std::int64_t>(tokens,
+                                                                   std::numeric_limits<std::int32_t>::min(),
+                                                                   std::numeric_limits<std::int32_t>::max()));
+    }
+
+    static std::uint32_t hash(const std::uint64_t (&key)[2], const std::uint8_t type) {
+        std::uint64_t h = (key[0] ^ (key[1] * 0x9E3779B97F4A7C15ULL) ^ type) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+        return static_cast<std::uint32_t>(h) | 1U;
+    }
+
+    /// Finds the entry of the address, creating one if there isn't any
+    Entry& find(const netadr_t& address) {
+        std::uint64_t key[2];
+        getKey(address, key);
+        return find(key, static_cast<std::uint8_t>(address.type));
+    }
+
+    Entry& find(const std::uint64_t (&key)[2], const std::uint8_t type) {
+        const std::uint32_t tag = hash(key, type);
+
+        Entry* entries = m_state->entries;
+        const std::size_t start = tag % CAPACITY;
+        for (std::size_t i = 0; i < PROBE_LIMIT; ++i) {
+            Entry& entry = entries[(start + i) % CAPACITY];
+            if (entry.tag == 0) {
+                return reset(entry, tag, key, type);
+            }
+            if (entry.tag == tag && entry.type == type && entry.address[0] == key[0] &&
+                entry.address[1] == key[1]) {
+                return entry;
+            }
+        }
+
+        // Second chance - clear the reference bits until an entry which wasn't used recently shows up
+        ++m_state->stats.evictions;
+        for (std::size_t i = 0;; ++i) {
+            Entry& entry = entries[(start + i % PROBE_LIMIT) % CAPACITY];
+            if (!entry.referenced) {
+                return reset(entry, tag, key, type);
+            }
+            entry.referenced = 0;
+        }
+    }
+
+    Entry& reset(Entry& entry,
+                 const std::uint32_t tag,
+                 const std::uint64_t (&key)[2],
+                 const std::uint8_t type) {
+        entry.tag = tag;
+        entry.lastSeen = m_now;
+        entry.address[0] = key[0];
+        entry.address[1] = key[1];
+        for (std::size_t i = 0; i < static_cast<std::size_t>(PacketClass::COUNT); ++i) {
+            entry.tokens[i] = m_limits[i].burst * TOKEN;
+        }
+        entry.replyTokens = m_replyLimit.burst * TOKEN;
+        entry.type = type;
+        entry.referenced = 0;
+        return entry;
+    }
+
+    state::StatePtr<State> m_state;
+    RateLimit m_limits[static_cast<std::size_t>(PacketClass::COUNT)] = { { 4, 10 }, { 2, 5 }, { 2, 5 } };
+    RateLimit m_replyLimit = { 0, 0 };
+    bool m_seedReplies = false; ///< The restored buckets are waiting for their reply budget.
+    std::uint32_t m_now = 0;
+};
+
+} // namespace example::net
+
+#endif // PLUGPP_EXAMPLE_NET_FLOODLIMITER_H
@@ -0,0 +1,78 @@
+#ifndef PLUGPP_EXAMPLE_NET_IPPOLICY_H
+#define PLUGPP_EXAMPLE_NET_IPPOLICY_H
+
+#include "plugpp-example/net/CidrTrie.h"
+#include "plugpp-example/util/WorkerPool.h"
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <spdlog/spdlog.h>
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace example::net {
+
+/// The currently active list of address ranges which can be replaced at any time
+///
+/// Lists are compiled (or their compiled form mapped) in the background and the new trie is swapped in
+/// atomically, so lookups never wait for a reload.
+class IpPolicy {
+public:
+    IpPolicy()
+        : m_trie(std::make_shared<const CidrTrie>(std::vector<IpRule>{}))
+        , m_loader(1, 1) {}
+
+    /// Returns the action of the most specific range covering the address
+    IpAction lookup(const netadr_t& address) const {
+        if (address.type == NA_IP) {
+            return std::atomic_load(&m_trie)->lookup(toIpKey4(address.ip));
+        }
+        if (address.type == NA_IP6) {
+            return std::atomic_load(&m_trie)->lookup(toIpKey6(address.ip6));
+        }
+        return IpAction::NONE;
+    }
+
+    /// Loads the list in the background and activates it once it's ready
+    /// @returns false if a reload is already in progress.
+    bool reload(std::string path) {
+        return m_loader.tryPost([this, path = std::move(path)] {
+            struct stat st {};
+            if (::stat(path.c_str(), &st) != 0 && errno == ENOENT) {
+                // Not having a list is the default, not an error
+                if (!m_missing) {
+                    spdlog::info("No IP list at '{}', no address ranges have a rule", path);
+                    m_missing = true;
+                }
+                std::atomic_store(&m_trie, std::make_shared<const CidrTrie>(std::vector<IpRule>{}));
+                return;
+            }
+            m_missing = false;
+            const auto start = std::chrono::steady_clock::now();
+            std::shared_ptr<const CidrTrie> trie = CidrTrie::fromFile(path);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            spdlog::info("Loaded {} IP rules ({} nodes, {} invalid lines) from '{}' in {} ms{}",
+                         trie->rules(),
+                         trie->nodes(),
+                         trie->invalid(),
+                         path,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(),
+                         trie->mapped() ? "" : " (not cached)");
+            std::atomic_store(&m_trie, std::move(trie));
+        });
+    }
+
+private:
+    std::shared_ptr<const CidrTrie> m_trie;
+    bool m_missing = false; ///< The missing list was reported, only used by the loader.
+    util::WorkerPool m_loader;
+};
+
+} // namespace example::net
+
+#endif // PLUGPP_EXAMPLE_NET_IPPOLICY_H
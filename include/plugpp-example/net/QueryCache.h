@@ -0,0 +1,217 @@
+#ifndef PLUGPP_EXAMPLE_NET_QUERYCACHE_H
+#define PLUGPP_EXAMPLE_NET_QUERYCACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string_view>
+
+namespace example::net {
+
+enum class QueryType : std::uint8_t {
+    INFO,   ///< getinfo, answered by infoResponse
+    STATUS, ///< getstatus, answered by statusResponse
+    COUNT,
+};
+
+/// A server browser query the @ref QueryCache can answer
+struct Query {
+    QueryType type;
+    std::string_view challenge; ///< Echoed in the response, may be empty.
+};
+
+struct QueryCacheStats {
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t learned;       ///< Responses of the engine stored.
+    std::uint64_t invalidations;
+};
+
+/// The last responses of the engine to the server browser queries, answered without rebuilding them
+///
+/// The responses are picked up as the engine sends them. The only part which differs between two requesters
+/// is the challenge echoed in the info string, so it's cut out and the rest is stored behind enough headroom
+/// for the packet header and any challenge. A hit writes the header and the requester's challenge right in
+/// front of the body and the buffer is sent as is. Responses are dropped after a time-to-live and whenever
+/// something they show changes, see @ref invalidate().
+class QueryCache {
+public:
+    static constexpr std::size_t MAX_CHALLENGE = 64;
+    static constexpr std::size_t MAX_RESPONSE = 16384;
+
+    QueryCache()
+        : m_responses(std::make_unique<Response[]>(static_cast<std::size_t>(QueryType::COUNT))) {}
+
+    /// Recognizes the queries the cache can answer
+    /// @returns false for other packets and for challenges which are better left to the engine.
+    static bool parse(const void* data, const int size, Query& query) {
+        const auto* bytes = static_cast<const char*>(data);
+        if (size < 4 || std::memcmp(bytes, MAGIC.data(), MAGIC.size()) != 0) {
+            return false;
+        }
+        const std::string_view text(bytes + 4, static_cast<std::size_t>(size - 4));
+        std::size_t pos = 0;
+        const std::string_view command = token(text, pos);
+        if (equalsIgnoreCase(command, "getinfo")) {
+            query.type = QueryType::INFO;
+        } else if (equalsIgnoreCase(command, "getstatus")) {
+            query.type = QueryType::STATUS;
+        } else {
+            return false;
+        }
+        query.challenge = token(text, pos);
+        if (query.challenge.size() > MAX_CHALLENGE) {
+            return false;
+        }
+        for (const char c : query.challenge) {
+            // The engine strips or rejects these in info strings
+            if (c < 0x20 || c >= 0x7F || c == '\\' || c == '"' || c == ';' || c == '%') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Sets the milliseconds a response is reused for, 0 disables the cache
+    void setTtl(const int ttl) { m_ttl = ttl; }
+
+    /// Drops the cached responses, e.g., when a player joins or the scores change
+    void invalidate() {
+        ++m_generation;
+        ++m_stats.invalidations;
+    }
+
+    /// Stores the packet if it's a response to a query
+    /// @param now The current time in milliseconds.
+    void learn(const void* data, const int size, const int now) {
+        const auto* bytes = static_cast<const char*>(data);
+        if (m_ttl <= 0 || size < 4 || std::memcmp(bytes, MAGIC.data(), MAGIC.size()) != 0) {
+            return;
+        }
+        const std::string_view text(bytes + 4, static_cast<std::size_t>(size - 4));
+        for (std::size_t type = 0; type < static_cast<std::size_t>(QueryType::COUNT); ++type) {
+            if (text.substr(0, RESPONSE_NAMES[type].size()) == RESPONSE_NAMES[type]) {
+                store(m_responses[type], text.substr(RESPONSE_NAMES[type].size()), now);
+                return;
+            }
+        }
+    }
+
+    /// Builds the response to the query in the cache's buffer
+    /// @param now The current time in milliseconds.
+    /// @returns The packet to send, valid until the next call, or an empty view if there's no valid response.
+    std::string_view respond(const Query& query, const int now) {
+        const auto type = static_cast<std::size_t>(query.type);
+        Response& response = m_responses[type];
+        if (!response.valid || response.generation != m_generation || now - response.learnedAt >= m_ttl) {
+            ++m_stats.misses;
+            return {};
+        }
+        ++m_stats.hits;
+        const std::string_view name = RESPONSE_NAMES[type];
+        const std::size_t challengeSize =
+            query.challenge.empty() ? 0 : CHALLENGE_KEY.size() + query.challenge.size();
+        const std::size_t headerSize = MAGIC.size() + name.size() + challengeSize;
+        char* packet = response.buffer + HEADROOM - headerSize;
+        char* out = packet;
+        for (const std::string_view part : { MAGIC, name }) {
+            std::memcpy(out, part.data(), part.size());
+            out += part.size();
+        }
+        if (!query.challenge.empty()) {
+            std::memcpy(out, CHALLENGE_KEY.data(), CHALLENGE_KEY.size());
+            std::memcpy(out + CHALLENGE_KEY.size(), query.challenge.data(), query.challenge.size());
+        }
+        return { packet, headerSize + response.length };
+    }
+
+    const QueryCacheStats& stats() const { return m_stats; }
+
+private:
+    static constexpr std::string_view MAGIC = "\xFF\xFF\xFF\xFF";
+    static constexpr std::string_view RESPONSE_NAMES[] = { "infoResponse\n", "statusResponse\n" };
+    static constexpr std::string_view CHALLENGE_KEY = "\\challenge\\";
+    static constexpr std::size_t HEADROOM = MAGIC.size() +
+                                            std::max(RESPONSE_NAMES[0].size(), RESPONSE_NAMES[1].size()) +
+                                            CHALLENGE_KEY.size() + MAX_CHALLENGE;
+    static_assert(std::size(RESPONSE_NAMES) == static_cast<std::size_t>(QueryType::COUNT));
+
+    struct Response {
+        char buffer[HEADROOM + MAX_RESPONSE];
+        std::size_t length; ///< Of the body following the headroom.
+        int learnedAt;
+        std::uint32_t generation;
+        bool valid;
+    };
+
+    /// Stores the body of the response without the challenge pair of its info string
+    void store(Response& response, const std::string_view body, const int now) {
+        const std::string_view info = body.substr(0, body.find('\n'));
+        std::size_t cut = info.size();
+        std::size_t cutLength = 0;
+        // Pairs of the info string are \key\value
+        for (std::size_t pos = 0; pos < info.size() && info[pos] == '\\';) {
+            const std::size_t valueStart = info.find('\\', pos + 1);
+            if (valueStart == std::string_view::npos) {
+                break;
+            }
+            const std::size_t valueEnd = std::min(info.find('\\', valueStart + 1), info.size());
+            if (equalsIgnoreCase(info.substr(pos + 1, valueStart - pos - 1), "challenge")) {
+                cut = pos;
+                cutLength = valueEnd - pos;
+                break;
+            }
+            pos = valueEnd;
+        }
+        if (body.size() - cutLength > MAX_RESPONSE) {
+            response.valid = false;
+            return;
+        }
+        char* out = response.buffer + HEADROOM;
+        std::memcpy(out, body.data(), cut);
+        std::memcpy(out + cut, body.data() + cut + cutLength, body.size() - cut - cutLength);
+        response.length = body.size() - cutLength;
+        response.learnedAt = now;
+        response.generation = m_generation;
+        response.valid = true;
+        ++m_stats.learned;
+    }
+
+    /// Returns the next whitespace-separated token
+    static std::string_view token(const std::string_view text, std::size_t& pos) {
+        const auto isSpace = [](const char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\0';
+        };
+        while (pos < text.size() && isSpace(text[pos])) {
+            ++pos;
+        }
+        const std::size_t start = pos;
+        while (pos < text.size() && !isSpace(text[pos])) {
+            ++pos;
+        }
+        return text.substr(start, pos - start);
+    }
+
+    static bool equalsIgnoreCase(const std::string_view text, const std::string_view lower) {
+        if (text.size() != lower.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            if ((text[i] | 0x20) != lower[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<Response[]> m_responses;
+    int m_ttl = 0;
+    std::uint32_t m_generation = 0;
+    QueryCacheStats m_stats{};
+};
+
+} // namespace example::net
+
+#endif // PLUGPP_EXAMPLE_NET_QUERYCACHE_H
@@ -0,0 +1,93 @@
+#ifndef PLUGPP_EXAMPLE_PERF_HISTOGRAM_H
+#define PLUGPP_EXAMPLE_PERF_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace example::perf {
+
+/// Log-linear histogram of latencies in nanoseconds
+///
+/// Every power of two is split into 8 linear sub-buckets (the HDR histogram layout with 3 significant bits),
+/// so any recorded value is reported with an error below 12.5 %. Recording is a couple of bit operations and
+/// an increment, the histogram has a fixed size and never allocates.
+class Histogram {
+public:
+    static constexpr std::uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr std::uint32_t SUB_BUCKETS = 1U << SUB_BUCKET_BITS;
+    static constexpr std::uint32_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(const std::uint64_t value) {
+        ++m_counts[indexOf(value)];
+        ++m_count;
+        m_sum += value;
+        m_max = std::max(m_max, value);
+    }
+
+    /// Returns the value below which the given fraction of the recorded values falls
+    /// @param quantile The quantile in the range [0, 1].
+    std::uint64_t percentile(const double quantile) const {
+        if (m_count == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(m_count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::uint32_t i = 0; i < BUCKETS; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) {
+                return std::min(upperBoundOf(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    /// Adds the values recorded by another histogram
+    void merge(const Histogram& other) {
+        for (std::uint32_t i = 0; i < BUCKETS; ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    void reset() { *this = Histogram(); }
+
+    std::uint64_t count() const { return m_count; }
+
+    std::uint64_t max() const { return m_max; }
+
+    std::uint64_t mean() const { return m_count == 0 ? 0 : m_sum / m_count; }
+
+    std::uint64_t sum() const { return m_sum; }
+
+private:
+    static std::uint32_t indexOf(const std::uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::uint32_t>(value);
+        }
+        const auto exponent = static_cast<std::uint32_t>(63 - __builtin_clzll(value));
+        const auto mantissa =
+            static_cast<std::uint32_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + mantissa;
+    }
+
+    static std::uint64_t upperBoundOf(const std::uint32_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const std::uint32_t exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+        const std::uint64_t mantissa = index % SUB_BUCKETS;
+        return ((SUB_BUCKETS + mantissa + 1) << (exponent - SUB_BUCKET_BITS)) - 1;
+    }
+
+    std::array<std::uint64_t, BUCKETS> m_counts{};
+    std::uint64_t m_count = 0;
+    std::uint64_t m_sum = 0;
+    std::uint64_t m_max = 0;
+};
+
+} // namespace example::perf
+
+#endif // PLUGPP_EXAMPLE_PERF_HISTOGRAM_H
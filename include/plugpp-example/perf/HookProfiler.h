@@ -0,0 +1,151 @@
+#ifndef PLUGPP_EXAMPLE_PERF_HOOKPROFILER_H
+#define PLUGPP_EXAMPLE_PERF_HOOKPROFILER_H
+
+#include "plugpp-example/perf/Histogram.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace example::perf {
+
+/// Plugin callbacks which are measured
+enum class Hook : std::uint8_t {
+    ON_MESSAGE_SENT,
+    ON_PLAYER_CONNECT,
+    ON_PLAYER_DISCONNECT,
+    ON_PLAYER_ADD_BAN,
+    ON_PLAYER_REMOVE_BAN,
+    ON_PLAYER_GOT_AUTH_INFO,
+    ON_PLAYER_GET_BAN_STATUS,
+    ON_PLAYER_ACCESS_GRANTED,
+    ON_PRE_FAST_RESTART,
+    ON_POST_FAST_RESTART,
+    ON_EXIT_LEVEL,
+    ON_SPAWN_SERVER,
+    ON_FRAME,
+    ON_CLIENT_SPAWN,
+    ON_CLIENT_ENTERED_WORLD,
+    ON_CLIENT_USER_INFO_CHANGED,
+    ON_CLIENT_MOVE_COMMAND,
+    ON_PLAYER_KILLED,
+    ON_PLAYER_RESERVED_SLOT_REQUEST,
+    ON_SCR_USERCALL_FUNCTION,
+    ON_SCR_USERCALL_METHOD,
+    ON_MODULE_LOADED,
+    ON_SCREENSHOT_ARRIVED,
+    ON_UDP_NET_EVENT,
+    ON_UDP_SEND,
+    COUNT,
+};
+
+constexpr std::string_view HOOK_NAMES[] = {
+    "onMessageSent",
+    "onPlayerConnect",
+    "onPlayerDisconnect",
+    "onPlayerAddBan",
+    "onPlayerRemoveBan",
+    "onPlayerGotAuthInfo",
+    "onPlayerGetBanStatus",
+    "onPlayerAccessGranted",
+    "onPreFastRestart",
+    "onPostFastRestart",
+    "onExitLevel",
+    "onSpawnServer",
+    "onFrame",
+    "onClientSpawn",
+    "onClientEnteredWorld",
+    "onClientUserInfoChanged",
+    "onClientMoveCommand",
+    "onPlayerKilled",
+    "onPlayerReservedSlotRequest",
+    "onScrUsercallFunction",
+    "onScrUsercallMethod",
+    "onModuleLoaded",
+    "onScreenshotArrived",
+    "onUdpNetEvent",
+    "onUdpSend",
+};
+static_assert(std::size(HOOK_NAMES) == static_cast<std::size_t>(Hook::COUNT));
+
+/// Latency histograms of the plugin callbacks and the plugin's share of every server frame
+///
+/// All the callbacks are invoked from the game thread, so is the profiler.
+class HookProfiler {
+public:
+    void record(const Hook hook, const std::uint64_t ns) {
+        m_hooks[static_cast<std::size_t>(hook)].record(ns);
+        m_frameNs += ns;
+    }
+
+    /// Closes the current frame
+    ///
+    /// @param budgetNs The time the plugin may spend in its callbacks per frame.
+    /// @returns The time spent in the callbacks since the previous call.
+    std::uint64_t endFrame(const std::uint64_t budgetNs) {
+        const std::uint64_t frameNs = m_frameNs;
+        m_frames.record(frameNs);
+        if (frameNs > budgetNs) {
+            ++m_overBudget;
+        }
+        m_frameNs = 0;
+        return frameNs;
+    }
+
+    const Histogram& hook(const Hook hook) const { return m_hooks[static_cast<std::size_t>(hook)]; }
+
+    /// Returns the histogram of the plugin time per frame
+    const Histogram& frames() const { return m_frames; }
+
+    /// Returns the number of frames the plugin went over the budget in
+    std::uint64_t overBudget() const { return m_overBudget; }
+
+    void reset() { *this = HookProfiler(); }
+
+private:
+    std::array<Histogram, static_cast<std::size_t>(Hook::COUNT)> m_hooks;
+    Histogram m_frames;
+    std::uint64_t m_frameNs = 0;
+    std::uint64_t m_overBudget = 0;
+};
+
+inline HookProfiler& profiler() {
+    static HookProfiler instance;
+    return instance;
+}
+
+/// Measures the lifetime of the object and records it for the hook
+class ScopedHookTimer {
+public:
+    explicit ScopedHookTimer(const Hook hook)
+        : m_hook(hook)
+        , m_start(std::chrono::steady_clock::now()) {}
+
+    ScopedHookTimer(const ScopedHookTimer&) = delete;
+    ScopedHookTimer& operator=(const ScopedHookTimer&) = delete;
+
+    ~ScopedHookTimer() noexcept {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        profiler().record(m_hook, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+private:
+    const Hook m_hook;
+    const std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace example::perf
+
+/// Measures the rest of the enclosing scope as the given plugin hook
+///
+/// Expands to nothing unless the plugin is built with PLUGPP_EXAMPLE_PROFILING.
+#ifdef PLUGPP_EXAMPLE_PROFILING
+#define EXAMPLE_PROFILE_HOOK(hook) \
+    const ::example::perf::ScopedHookTimer exampleHookTimer_(::example::perf::Hook::hook)
+#else
+#define EXAMPLE_PROFILE_HOOK(hook) static_cast<void>(0)
+#endif
+
+#endif // PLUGPP_EXAMPLE_PERF_HOOKPROFILER_H
@@ -0,0 +1,43 @@
+#ifndef PLUGPP_EXAMPLE_SCHED_FRAMECLOCK_H
+#define PLUGPP_EXAMPLE_SCHED_FRAMECLOCK_H
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <cstdint>
+
+namespace example::sched {
+
+/// Game time advanced by the length of every server frame
+///
+/// The length of a frame is derived from the current value of `sv_fps`, so the clock stays correct when the
+/// frame rate is changed at runtime.
+class FrameClock {
+public:
+    /// Advances the clock by one server frame, shall be called once per frame
+    void tick() {
+        const int fps = Plugin_Cvar_VariableIntegerValue("sv_fps");
+        m_frameUs = 1000000U / static_cast<std::uint32_t>(fps > 0 ? fps : DEFAULT_FPS);
+        m_nowUs += m_frameUs;
+        ++m_frames;
+    }
+
+    /// Returns the game time in milliseconds
+    std::uint64_t now() const { return m_nowUs / 1000; }
+
+    /// Returns the length of the last frame in microseconds
+    std::uint32_t frameLength() const { return m_frameUs; }
+
+    /// Returns the number of frames since the clock was created
+    std::uint64_t frames() const { return m_frames; }
+
+private:
+    static constexpr int DEFAULT_FPS = 20;
+
+    std::uint64_t m_nowUs = 0;
+    std::uint32_t m_frameUs = 1000000U / DEFAULT_FPS;
+    std::uint64_t m_frames = 0;
+};
+
+} // namespace example::sched
+
+#endif // PLUGPP_EXAMPLE_SCHED_FRAMECLOCK_H
@@ -0,0 +1,314 @@
+#ifndef PLUGPP_EXAMPLE_SCHED_SCHEDULER_H
+#define PLUGPP_EXAMPLE_SCHED_SCHEDULER_H
+
+#include "plugpp-example/io/log.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace example::sched {
+
+/// Identifier of a scheduled task, 0 is never a valid identifier
+using TaskId = std::uint64_t;
+
+/// Hierarchical timing wheel of delayed and periodic tasks
+///
+/// Four levels of 64 slots with a resolution of one millisecond cover delays of up to ~4.6 hours, longer
+/// delays are re-cascaded from the last level. Scheduling, cancelling and advancing by one tick are O(1).
+/// Task nodes are pooled and linked intrusively, so apart from growing the pool the scheduler doesn't
+/// allocate (a task itself may allocate if its callable doesn't fit into std::function's small buffer).
+///
+/// Tasks may be owned by a client slot, all the tasks of a slot can then be cancelled at once, e.g., when the
+/// client disconnects.
+///
+/// Shall only be used from the game thread.
+class Scheduler {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr int NO_OWNER = -1;
+    static constexpr int MAX_OWNERS = 64;
+
+    explicit Scheduler(const std::size_t capacity = 1024) {
+        reserve(capacity + SENTINELS);
+        for (std::uint32_t i = 0; i < SENTINELS; ++i) {
+            Node& sentinel = node(allocate());
+            sentinel.prev = sentinel.next = sentinel.ownerPrev = sentinel.ownerNext = i;
+        }
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /// Runs the task once after the delay
+    ///
+    /// @param delay Delay in milliseconds, 0 runs the task during the next @ref advance().
+    /// @param owner Slot of the client owning the task or @ref NO_OWNER.
+    TaskId schedule(const std::uint64_t delay, Task task, const int owner = NO_OWNER) {
+        return add(delay, 0, std::move(task), owner);
+    }
+
+    /// Runs the task repeatedly with the given period, the first time after one period
+    ///
+    /// @param interval Period in milliseconds, at least 1.
+    /// @param owner Slot of the client owning the task or @ref NO_OWNER.
+    TaskId schedulePeriodic(const std::uint64_t interval, Task task, const int owner = NO_OWNER) {
+        return add(interval, interval > 0 ? interval : 1, std::move(task), owner);
+    }
+
+    /// Cancels the task
+    /// @returns true if the task was still pending.
+    bool cancel(const TaskId id) {
+        const auto index = static_cast<std::uint32_t>(id);
+        const auto generation = static_cast<std::uint32_t>(id >> 32);
+        if (index < SENTINELS || index >= m_size) {
+            return false;
+        }
+        Node& n = node(index);
+        if (n.generation != generation || n.state == State::FREE || n.cancelled) {
+            return false;
+        }
+        if (n.state == State::RUNNING) {
+            n.cancelled = true; // Released once it returns
+        } else {
+            release(index);
+        }
+        return true;
+    }
+
+    /// Cancels all the tasks owned by the client slot
+    void cancelOwner(const int owner) {
+        if (owner < 0 || owner >= MAX_OWNERS) {
+            return;
+        }
+        const std::uint32_t head = OWNER_HEADS + static_cast<std::uint32_t>(owner);
+        for (std::uint32_t index = node(head).ownerNext; index != head;) {
+            const std::uint32_t next = node(index).ownerNext;
+            cancel(idOf(index));
+            index = next;
+        }
+    }
+
+    /// Advances the wheel to the given time and runs the due tasks
+    ///
+    /// Tasks which are due but don't fit into the budget are kept in order and run first during the next
+    /// call.
+    ///
+    /// @param now The current time in milliseconds.
+    /// @param budget The maximum number of tasks to run.
+    /// @returns The number of tasks run.
+    std::size_t advance(const std::uint64_t now, const std::size_t budget) {
+        while (m_time <= now) {
+            std::uint64_t index = m_time & SLOT_MASK;
+            for (std::uint32_t level = 1; index == 0 && level < LEVELS; ++level) {
+                index = (m_time >> (level * SLOT_BITS)) & SLOT_MASK;
+                cascade(level, static_cast<std::uint32_t>(index));
+            }
+            spliceToReady(slotHead(0, static_cast<std::uint32_t>(m_time & SLOT_MASK)));
+            ++m_time;
+        }
+
+        std::size_t executed = 0;
+        while (executed < budget && node(READY_HEAD).next != READY_HEAD) {
+            run(node(READY_HEAD).next);
+            ++executed;
+        }
+        return executed;
+    }
+
+    /// Returns the number of scheduled tasks
+    std::size_t pending() const { return m_pending; }
+
+    /// Returns the number of due tasks waiting for the next @ref advance()
+    std::size_t backlog() const {
+        std::size_t count = 0;
+        for (std::uint32_t index = node(READY_HEAD).next; index != READY_HEAD; index = node(index).next) {
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    static constexpr std::uint32_t LEVELS = 4;
+    static constexpr std::uint32_t SLOT_BITS = 6;
+    static constexpr std::uint32_t SLOTS = 1U << SLOT_BITS;
+    static constexpr std::uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr std::uint64_t MAX_DELAY = (1ULL << (LEVELS * SLOT_BITS)) - 1;
+
+    static constexpr std::uint32_t READY_HEAD = LEVELS * SLOTS;
+    static constexpr std::uint32_t OWNER_HEADS = READY_HEAD + 1;
+    static constexpr std::uint32_t SENTINELS = OWNER_HEADS + MAX_OWNERS;
+
+    static constexpr std::uint32_t CHUNK_BITS = 8;
+    static constexpr std::uint32_t CHUNK_SIZE = 1U << CHUNK_BITS;
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    enum class State : std::uint8_t { FREE, SCHEDULED, READY, RUNNING };
+
+    struct Node {
+        Task task;
+        std::uint64_t expires = 0;
+        std::uint64_t interval = 0;
+        std::uint32_t generation = 1;
+        std::uint32_t prev = NONE;
+        std::uint32_t next = NONE;
+        std::uint32_t ownerPrev = NONE;
+        std::uint32_t ownerNext = NONE;
+        State state = State::FREE;
+        bool cancelled = false;
+    };
+
+    // Nodes are allocated in chunks so they never move, a running task may schedule new ones
+    Node& node(const std::uint32_t index) { return m_chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)]; }
+    const Node& node(const std::uint32_t index) const {
+        return m_chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+    }
+
+    TaskId idOf(const std::uint32_t index) const {
+        return (static_cast<TaskId>(node(index).generation) << 32) | index;
+    }
+
+    static std::uint32_t slotHead(const std::uint32_t level, const std::uint32_t slot) {
+        return level * SLOTS + slot;
+    }
+
+    /// Makes sure the pool has room for the given number of nodes including the sentinels
+    void reserve(const std::size_t nodes) {
+        while (m_chunks.size() * CHUNK_SIZE < nodes) {
+            m_chunks.push_back(std::make_unique<Node[]>(CHUNK_SIZE));
+        }
+    }
+
+    std::uint32_t allocate() {
+        if (m_free != NONE) {
+            const std::uint32_t index = m_free;
+            m_free = node(index).next;
+            return index;
+        }
+        reserve(m_size + 1);
+        return m_size++;
+    }
+
+    TaskId add(const std::uint64_t delay, const std::uint64_t interval, Task task, const int owner) {
+        const std::uint32_t index = allocate();
+        Node& n = node(index);
+        n.task = std::move(task);
+        n.interval = interval;
+        n.cancelled = false;
+        n.ownerPrev = n.ownerNext = NONE;
+        if (owner >= 0 && owner < MAX_OWNERS) {
+            link(OWNER_HEADS + static_cast<std::uint32_t>(owner), index, &Node::ownerPrev, &Node::ownerNext);
+        }
+        insert(index, m_time + delay);
+        ++m_pending;
+        return idOf(index);
+    }
+
+    /// Places the node into the slot of the wheel corresponding to its expiration time
+    void insert(const std::uint32_t index, std::uint64_t expires) {
+        Node& n = node(index);
+        expires = std::max(expires, m_time);
+        n.expires = expires;
+        n.state = State::SCHEDULED;
+
+        const std::uint64_t delta = std::min(expires - m_time, MAX_DELAY);
+        const std::uint64_t slotTime = m_time + delta;
+        std::uint32_t level = 0;
+        while (level + 1 < LEVELS && delta >= (1ULL << ((level + 1) * SLOT_BITS))) {
+            ++level;
+        }
+        const auto slot = static_cast<std::uint32_t>((slotTime >> (level * SLOT_BITS)) & SLOT_MASK);
+        link(slotHead(level, slot), index, &Node::prev, &Node::next);
+    }
+
+    /// Redistributes the nodes of a higher level slot into the lower levels
+    void cascade(const std::uint32_t level, const std::uint32_t slot) {
+        const std::uint32_t head = slotHead(level, slot);
+        std::uint32_t index = node(head).next;
+        node(head).prev = node(head).next = head;
+        while (index != head) {
+            const std::uint32_t next = node(index).next;
+            insert(index, node(index).expires);
+            index = next;
+        }
+    }
+
+    void spliceToReady(const std::uint32_t head) {
+        std::uint32_t index = node(head).next;
+        node(head).prev = node(head).next = head;
+        while (index != head) {
+            const std::uint32_t next = node(index).next;
+            node(index).state = State::READY;
+            link(READY_HEAD, index, &Node::prev, &Node::next);
+            index = next;
+        }
+    }
+
+    void run(const std::uint32_t index) {
+        unlink(index, &Node::prev, &Node::next);
+        node(index).state = State::RUNNING;
+        try {
+            node(index).task();
+        } catch (const std::exception& e) {
+            EXAMPLE_LOG_RATE_LIMITED(err, 10, 10 * 1000, "Scheduled task failed: {}", e.what());
+        }
+        Node& n = node(index);
+        if (n.interval > 0 && !n.cancelled) {
+            insert(index, m_time - 1 + n.interval);
+        } else {
+            release(index);
+        }
+    }
+
+    void release(const std::uint32_t index) {
+        Node& n = node(index);
+        if (n.state == State::SCHEDULED || n.state == State::READY) {
+            unlink(index, &Node::prev, &Node::next);
+        }
+        if (n.ownerNext != NONE) {
+            unlink(index, &Node::ownerPrev, &Node::ownerNext);
+        }
+        n.task = nullptr;
+        n.state = State::FREE;
+        n.cancelled = false;
+        ++n.generation;
+        n.next = m_free;
+        m_free = index;
+        --m_pending;
+    }
+
+    /// Appends the node to the circular list with the given sentinel
+    void link(const std::uint32_t head,
+              const std::uint32_t index,
+              std::uint32_t Node::*prev,
+              std::uint32_t Node::*next) {
+        Node& sentinel = node(head);
+        Node& n = node(index);
+        n.*prev = sentinel.*prev;
+        n.*next = head;
+        node(sentinel.*prev).*next = index;
+        sentinel.*prev = index;
+    }
+
+    void unlink(const std::uint32_t index, std::uint32_t Node::*prev, std::uint32_t Node::*next) {
+        Node& n = node(index);
+        node(n.*prev).*next = n.*next;
+        node(n.*next).*prev = n.*prev;
+        n.*prev = n.*next = NONE;
+    }
+
+    std::vector<std::unique_ptr<Node[]>> m_chunks;
+    std::uint32_t m_size = 0;
+    std::uint32_t m_free = NONE;
+    std::size_t m_pending = 0;
+    std::uint64_t m_time = 0; ///< The next tick to be processed, the time starts at 0.
+};
+
+} // namespace example::sched
+
+#endif // PLUGPP_EXAMPLE_SCHED_SCHEDULER_H
@@ -0,0 +1,156 @@
+#ifndef PLUGPP_EXAMPLE_SCREENSHOT_SCREENSHOT_H
+#define PLUGPP_EXAMPLE_SCREENSHOT_SCREENSHOT_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace example::screenshot {
+
+/// A whole file mapped read-only, so it's processed without copying it into the process
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            m_error = errno;
+            return;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            m_error = errno;
+        } else if (st.st_size > 0) {
+            const auto size = static_cast<std::size_t>(st.st_size);
+            void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                m_error = errno;
+            } else {
+                ::madvise(data, size, MADV_SEQUENTIAL);
+                m_data = static_cast<const std::uint8_t*>(data);
+                m_size = size;
+            }
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (m_data) {
+            ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+        }
+    }
+
+    /// Returns the errno of the failed call, 0 if the file got mapped or is empty
+    int error() const { return m_error; }
+
+    const std::uint8_t* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const std::uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+    int m_error = 0;
+};
+
+/// 64-bit hash of the content, good enough to tell screenshots apart
+///
+/// Four lanes of multiply-rotate rounds over 8-byte words, the lanes don't depend on each other so a few
+/// megabytes are hashed at memory speed.
+inline std::uint64_t contentHash(const void* data, const std::size_t size) {
+    constexpr std::uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    constexpr std::uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr auto rotl = [](const std::uint64_t x, const int r) { return x << r | x >> (64 - r); };
+    constexpr auto round = [rotl](const std::uint64_t acc, const std::uint64_t word) {
+        return rotl(acc + word * PRIME2, 31) * PRIME1;
+    };
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    std::uint64_t lanes[4] = { PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1 };
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i + lane * 8, sizeof(word));
+            lanes[lane] = round(lanes[lane], word);
+        }
+    }
+    std::uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18) + size;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        h = rotl(h ^ round(0, word), 27) * PRIME1 + PRIME2;
+    }
+    for (; i < size; ++i) {
+        h = rotl(h ^ (bytes[i] * PRIME1), 11) * PRIME2;
+    }
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    return h;
+}
+
+/// What the headers of a JPEG file tell about the picture
+struct JpegInfo {
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint8_t components;
+    bool complete;          ///< The file ends with the end of image marker.
+    std::size_t scanBytes;  ///< Of the entropy-coded data, from the start of scan to the end of the file.
+};
+
+/// Walks the markers of a JPEG file up to the start of scan, nothing gets decoded
+/// @returns false if it isn't a JPEG file or there's no frame header.
+inline bool inspectJpeg(const std::uint8_t* data, const std::size_t size, JpegInfo& info) {
+    info = JpegInfo{};
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return false;
+    }
+    bool frame = false;
+    std::size_t pos = 2;
+    while (pos + 4 <= size) {
+        if (data[pos] != 0xFF) {
+            return false;
+        }
+        const std::uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            ++pos; // Fill byte
+            continue;
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            pos += 2; // Markers without a segment
+            continue;
+        }
+        const std::size_t length = std::size_t{ data[pos + 2] } << 8 | data[pos + 3];
+        if (length < 2 || pos + 2 + length > size) {
+            return false;
+        }
+        const std::uint8_t* segment = data + pos + 4;
+        // Start of frame markers, except DHT, JPG and DAC which share the range
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            if (length < 8) {
+                return false;
+            }
+            info.height = static_cast<std::uint16_t>(segment[1] << 8 | segment[2]);
+            info.width = static_cast<std::uint16_t>(segment[3] << 8 | segment[4]);
+            info.components = segment[5];
+            frame = true;
+        } else if (marker == 0xDA) {
+            info.scanBytes = size - (pos + 2 + length);
+            break;
+        }
+        pos += 2 + length;
+    }
+    info.complete = data[size - 2] == 0xFF && data[size - 1] == 0xD9;
+    return frame && info.width > 0 && info.height > 0;
+}
+
+} // namespace example::screenshot
+
+#endif // PLUGPP_EXAMPLE_SCREENSHOT_SCREENSHOT_H
@@ -0,0 +1,307 @@
+#ifndef PLUGPP_EXAMPLE_SCREENSHOT_SCREENSHOTPIPELINE_H
+#define PLUGPP_EXAMPLE_SCREENSHOT_SCREENSHOTPIPELINE_H
+
+#include "plugpp-example/io/log.h"
+#include "plugpp-example/perf/Histogram.h"
+#include "plugpp-example/screenshot/Screenshot.h"
+#include "plugpp-example/util/WorkerPool.h"
+
+#include <spdlog/fmt/fmt.h>
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace example::screenshot {
+
+enum class Stage : std::uint8_t {
+    QUEUE,   ///< Waiting for a worker
+    MAP,     ///< Opening and mapping the file
+    HASH,    ///< Hashing the content
+    INSPECT, ///< Walking the JPEG headers
+    STORE,   ///< Linking the file into the content-addressed store
+    COUNT,
+};
+
+constexpr const char* STAGE_NAMES[] = { "queue", "map", "hash", "inspect", "store" };
+
+/// Reasons to take a closer look at the player
+enum Flag : std::uint8_t {
+    MALFORMED = 1 << 0, ///< Not a JPEG file, or a truncated one.
+    BLANK = 1 << 1,     ///< Next to no image data, e.g., a black frame sent instead of the game.
+    REPEATED = 1 << 2,  ///< The player sent exactly the same picture before.
+    FOREIGN = 1 << 3,   ///< Exactly the same picture was sent by another player.
+};
+
+/// A processed screenshot handed back to the game thread
+struct Result {
+    int slot;
+    std::uint64_t playerid;
+    std::string path;
+    std::string error; ///< Set if the file couldn't be processed.
+    std::uint64_t hash;
+    std::size_t size;
+    JpegInfo jpeg;
+    bool stored; ///< Linked into the store, false if disabled or already there.
+    std::uint8_t flags;
+    std::uint64_t stageNs[static_cast<std::size_t>(Stage::COUNT)];
+};
+
+/// A screenshot known to the index
+struct IndexEntry {
+    std::uint64_t sequence;
+    std::uint64_t playerid;
+    std::uint64_t hash;
+    std::uint64_t previous; ///< Sequence of the player's screenshot before this one, 0 for none.
+    std::uint32_t size;
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint8_t flags;
+};
+
+/// Processes the screenshots which arrive on the server on a few worker threads
+///
+/// A screenshot is mapped, hashed, checked and optionally linked into a content-addressed store by a worker,
+/// the game thread only queues it and collects the results by @ref poll(). When the queue is full the
+/// screenshots wait in a bounded backlog of the game thread, and once that is full too they're skipped.
+/// The results are indexed per player in a ring of the last screenshots, which is also used to find
+/// pictures sent more than once. Every stage is timed.
+class ScreenshotPipeline {
+public:
+    struct Settings {
+        std::size_t workers;
+        std::size_t queueCapacity;
+        std::size_t backlogCapacity; ///< Screenshots waiting on the game thread for a free queue slot.
+        std::size_t indexCapacity;   ///< Screenshots kept in the index.
+        double blankBitsPerPixel;    ///< Compressed bits per pixel below which a picture is blank.
+    };
+
+    struct Stats {
+        std::uint64_t submitted;
+        std::uint64_t deferred; ///< Went through the backlog.
+        std::uint64_t skipped;  ///< Dropped because the backlog was full.
+        std::uint64_t processed;
+        std::uint64_t failed;
+        std::uint64_t flagged;
+    };
+
+    explicit ScreenshotPipeline(const Settings& settings)
+        : m_settings(settings)
+        , m_index(settings.indexCapacity)
+        , m_workers(settings.workers, settings.queueCapacity) {}
+
+    /// Sets the directory the screenshots are linked into under the name of their hash, empty disables it
+    void setStoreDirectory(std::string directory) { m_storeDirectory = std::move(directory); }
+
+    /// Queues the screenshot for processing
+    /// @returns false if it got skipped.
+    bool submit(const int slot, const std::uint64_t playerid, std::string path) {
+        ++m_stats.submitted;
+        Job job{ slot, playerid, std::move(path), m_storeDirectory, std::chrono::steady_clock::now() };
+        // The backlog goes first so the screenshots stay in order
+        if (m_backlog.empty() && post(job)) {
+            return true;
+        }
+        if (m_backlog.size() >= m_settings.backlogCapacity) {
+            ++m_stats.skipped;
+            EXAMPLE_LOG_RATE_LIMITED(
+                warn, 10, 10 * 1000, "Screenshot queue is full, skipping '{}' of slot {}", job.path, slot);
+            return false;
+        }
+        ++m_stats.deferred;
+        m_backlog.push_back(std::move(job));
+        return true;
+    }
+
+    /// Indexes the finished screenshots and calls the function with each of them
+    ///
+    /// Shall be called from the game thread, e.g., every server frame.
+    template <typename Fn>
+    void poll(Fn&& fn) {
+        while (!m_backlog.empty() && post(m_backlog.front())) {
+            m_backlog.pop_front();
+        }
+        {
+            std::lock_guard lock(m_resultsMutex);
+            m_completed.swap(m_results);
+        }
+        for (Result& result : m_completed) {
+            // The stages after a failed one didn't run
+            const auto stages = static_cast<std::size_t>(result.error.empty() ? Stage::COUNT : Stage::HASH);
+            for (std::size_t stage = 0; stage < stages; ++stage) {
+                m_stageTimes[stage].record(result.stageNs[stage]);
+            }
+            if (!result.error.empty()) {
+                ++m_stats.failed;
+            } else {
+                ++m_stats.processed;
+                index(result);
+                m_stats.flagged += result.flags != 0 ? 1 : 0;
+            }
+            fn(static_cast<const Result&>(result));
+        }
+        m_completed.clear();
+    }
+
+    /// Calls the function with the indexed screenshots of the player, the latest first
+    template <typename Fn>
+    void forEachOf(const std::uint64_t playerid, Fn&& fn) const {
+        auto it = m_latest.find(playerid);
+        for (std::uint64_t sequence = it == m_latest.end() ? 0 : it->second; sequence != 0;) {
+            const IndexEntry& entry = m_index[sequence % m_index.size()];
+            if (entry.sequence != sequence) {
+                break; // Overwritten by a newer screenshot
+            }
+            fn(entry);
+            sequence = entry.previous;
+        }
+    }
+
+    const Stats& stats() const { return m_stats; }
+
+    const perf::Histogram& stageTimes(const Stage stage) const {
+        return m_stageTimes[static_cast<std::size_t>(stage)];
+    }
+
+    /// Returns the number of screenshots waiting for a worker or in the backlog
+    std::size_t pending() const { return m_workers.pending() + m_backlog.size(); }
+
+private:
+    struct Job {
+        int slot;
+        std::uint64_t playerid;
+        std::string path;
+        std::string storeDirectory;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    bool post(const Job& job) {
+        return m_workers.tryPost([this, job] {
+            Result result = process(job, m_settings.blankBitsPerPixel);
+            std::lock_guard lock(m_resultsMutex);
+            m_results.push_back(std::move(result));
+        });
+    }
+
+    /// Runs the stages on a worker thread
+    static Result process(const Job& job, const double blankBitsPerPixel) {
+        Result result{};
+        result.slot = job.slot;
+        result.playerid = job.playerid;
+        result.path = job.path;
+        auto last = job.queuedAt;
+        const auto finish = [&](const Stage stage) {
+            const auto now = std::chrono::steady_clock::now();
+            result.stageNs[static_cast<std::size_t>(stage)] = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+            last = now;
+        };
+        finish(Stage::QUEUE);
+
+        const MappedFile file(job.path);
+        finish(Stage::MAP);
+        if (file.error() != 0) {
+            result.error = std::strerror(file.error());
+            return result;
+        }
+        result.size = file.size();
+
+        result.hash = contentHash(file.data(), file.size());
+        finish(Stage::HASH);
+
+        if (!inspectJpeg(file.data(), file.size(), result.jpeg) || !result.jpeg.complete) {
+            result.flags |= MALFORMED;
+        } else if (const double pixels = static_cast<double>(result.jpeg.width) * result.jpeg.height;
+                   static_cast<double>(result.jpeg.scanBytes) * 8 < blankBitsPerPixel * pixels) {
+            result.flags |= BLANK;
+        }
+        finish(Stage::INSPECT);
+
+        if (!job.storeDirectory.empty()) {
+            const std::string target = fmt::format("{}/{:016x}.jpg", job.storeDirectory, result.hash);
+            // A hard link shares the data with the original, the same content is only ever stored once
+            if (::link(job.path.c_str(), target.c_str()) == 0) {
+                result.stored = true;
+            } else if (const int error = errno; error != EEXIST) {
+                EXAMPLE_LOG_RATE_LIMITED(warn,
+                                         10,
+                                         10 * 1000,
+                                         "Can't store the screenshot as '{}': {}",
+                                         target,
+                                         std::strerror(error));
+            }
+        }
+        finish(Stage::STORE);
+        return result;
+    }
+
+    /// Adds the screenshot to the index and flags it if its picture is already known
+    void index(Result& result) {
+        auto [first, end] = m_byHash.equal_range(result.hash);
+        for (auto it = first; it != end; ++it) {
+            const IndexEntry& known = m_index[it->second % m_index.size()];
+            result.flags |= known.playerid == result.playerid ? REPEATED : FOREIGN;
+        }
+
+        const std::uint64_t sequence = ++m_sequence;
+        IndexEntry& entry = m_index[sequence % m_index.size()];
+        if (entry.sequence != 0) {
+            forget(entry);
+        }
+        auto latest = m_latest.find(result.playerid);
+        entry = IndexEntry{ sequence,
+                            result.playerid,
+                            result.hash,
+                            latest == m_latest.end() ? 0 : latest->second,
+                            static_cast<std::uint32_t>(result.size),
+                            result.jpeg.width,
+                            result.jpeg.height,
+                            result.flags };
+        m_latest[result.playerid] = sequence;
+        m_byHash.emplace(result.hash, sequence);
+    }
+
+    /// Removes the entry about to be overwritten from the lookups
+    void forget(const IndexEntry& entry) {
+        auto [first, end] = m_byHash.equal_range(entry.hash);
+        for (auto it = first; it != end; ++it) {
+            if (it->second == entry.sequence) {
+                m_byHash.erase(it);
+                break;
+            }
+        }
+        if (auto it = m_latest.find(entry.playerid); it != m_latest.end() && it->second == entry.sequence) {
+            m_latest.erase(it);
+        }
+    }
+
+    const Settings m_settings;
+    std::string m_storeDirectory;
+    std::deque<Job> m_backlog;
+    Stats m_stats{};
+    perf::Histogram m_stageTimes[static_cast<std::size_t>(Stage::COUNT)];
+
+    std::vector<IndexEntry> m_index;
+    std::uint64_t m_sequence = 0;
+    std::unordered_map<std::uint64_t, std::uint64_t> m_latest;     ///< Player ID to the latest sequence.
+    std::unordered_multimap<std::uint64_t, std::uint64_t> m_byHash; ///< Hash to the sequences.
+
+    std::mutex m_resultsMutex;
+    std::vector<Result> m_results;
+    std::vector<Result> m_completed;
+
+    // Declared last so the workers are joined before the rest of the members is destroyed
+    util::WorkerPool m_workers;
+};
+
+} // namespace example::screenshot
+
+#endif // PLUGPP_EXAMPLE_SCREENSHOT_SCREENSHOTPIPELINE_H
@@ -0,0 +1,105 @@
+#ifndef PLUGPP_EXAMPLE_STATE_STATEFORMAT_H
+#define PLUGPP_EXAMPLE_STATE_STATEFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/// Layout of the state handed over from a plugin instance to the one replacing it
+///
+/// The state is a sealed memfd starting with a @ref ArenaHeader, followed by a fixed table of
+/// @ref SectionEntry and the sections themselves, every one of them aligned to @ref SECTION_ALIGNMENT. A
+/// section is either the raw bytes of a trivially copyable structure (@ref SectionKind::POD), which the new
+/// instance uses in place when its layout version and size match, or a sequence of records
+/// (@ref SectionKind::RECORDS) describing the same state independently of the in-memory layout, which is
+/// used when they don't.
+namespace example::state {
+
+/// Components carrying state across reloads, the values are stored and shall never be reused
+enum class SectionId : std::uint32_t {
+    FLOOD_LIMITER = 1,
+    MOVE_ANALYZER,
+    USERINFO,
+    BAN_CACHE,
+    MATCH_STATS,
+};
+
+enum class SectionKind : std::uint32_t {
+    POD = 1,
+    RECORDS,
+};
+
+constexpr char ARENA_MAGIC[8] = { 'P', 'P', 'X', 'S', 'T', 'A', 'T', 'E' };
+constexpr std::uint32_t ARENA_VERSION = 1;
+constexpr std::size_t MAX_SECTIONS = 16;
+constexpr std::size_t SECTION_ALIGNMENT = 64;
+
+/// Environment variable holding the descriptor of the memfd while no plugin instance owns it
+constexpr const char* ARENA_FD_VARIABLE = "PLUGPP_EXAMPLE_STATE_FD";
+
+struct ArenaHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t sections;
+    std::uint64_t size;       ///< Size of the whole arena in bytes.
+    std::uint64_t generation; ///< Number of reloads the state went through.
+    std::uint64_t pid;        ///< Process the arena was written by, the state never leaves it.
+    std::uint64_t checksum;   ///< Of the section table.
+};
+static_assert(sizeof(ArenaHeader) == 48);
+
+struct SectionEntry {
+    SectionId id;
+    SectionKind kind;
+    std::uint32_t version; ///< Layout version of the structure or the records.
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint64_t checksum;
+};
+static_assert(sizeof(SectionEntry) == 40);
+
+/// Precedes every record of a @ref SectionKind::RECORDS section, the payload is padded to 8 bytes
+struct RecordHeader {
+    std::uint32_t tag;
+    std::uint32_t size; ///< Of the payload without the padding.
+};
+static_assert(sizeof(RecordHeader) == 8);
+
+constexpr std::size_t alignUp(const std::size_t size, const std::size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/// Offset of the first section
+constexpr std::size_t DATA_OFFSET =
+    alignUp(sizeof(ArenaHeader) + MAX_SECTIONS * sizeof(SectionEntry), SECTION_ALIGNMENT);
+
+/// 64-bit checksum of the bytes, fast enough to cover a few megabytes on every reload
+inline std::uint64_t checksum(const void* data, const std::size_t size) {
+    constexpr std::uint64_t PRIME = 0x100000001B3ULL;
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    // Four independent lanes so the multiplications overlap
+    std::uint64_t lanes[4] = { 0xCBF29CE484222325ULL, 0x84222325CBF29CE4ULL, 0x9E3779B97F4A7C15ULL, size };
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i + lane * 8, sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * PRIME;
+        }
+    }
+    std::uint64_t h = lanes[0] ^ (lanes[1] << 1 | lanes[1] >> 63) ^ (lanes[2] << 2 | lanes[2] >> 62) ^
+                      (lanes[3] << 3 | lanes[3] >> 61);
+    for (; i < size; ++i) {
+        h = (h ^ bytes[i]) * PRIME;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace example::state
+
+#endif // PLUGPP_EXAMPLE_STATE_STATEFORMAT_H
@@ -0,0 +1,208 @@
+#ifndef PLUGPP_EXAMPLE_STATE_STATESNAPSHOT_H
+#define PLUGPP_EXAMPLE_STATE_STATESNAPSHOT_H
+
+#include "plugpp-example/state/StateFormat.h"
+
+#include <spdlog/spdlog.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace example::state {
+
+/// A record of a @ref SectionKind::RECORDS section
+struct Record {
+    std::uint32_t tag;
+    const void* data;
+    std::size_t size;
+
+    /// Copies the payload, it shall have exactly the size of the structure
+    template <typename T>
+    bool read(T& payload) const {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (size != sizeof(payload)) {
+            return false;
+        }
+        std::memcpy(&payload, data, sizeof(payload));
+        return true;
+    }
+};
+
+/// The state left behind by the previous instance of the plugin, see @ref StateWriter
+///
+/// The arena is mapped privately, so adopted structures are used and modified in place while the pages which
+/// are never written stay shared with the sealed memfd. The snapshot shall outlive everything adopted from
+/// it. Sections are only handed out when their checksum matches.
+class StateSnapshot {
+public:
+    /// Takes over the arena published in this process, if there's any
+    StateSnapshot() {
+        const char* variable = std::getenv(ARENA_FD_VARIABLE);
+        if (!variable) {
+            return;
+        }
+        const int fd = std::atoi(variable);
+        ::unsetenv(ARENA_FD_VARIABLE);
+        // A descriptor inherited through exec() or reused for another file must be left alone
+        ArenaHeader header{};
+        if (fd < 0 || (::fcntl(fd, F_GET_SEALS) & F_SEAL_WRITE) == 0 ||
+            ::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, ARENA_MAGIC, sizeof(ARENA_MAGIC)) != 0 ||
+            header.pid != static_cast<std::uint64_t>(::getpid())) {
+            return;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && static_cast<std::uint64_t>(st.st_size) == header.size &&
+            header.size >= DATA_OFFSET) {
+            void* data = ::mmap(nullptr, header.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_mapping = static_cast<std::uint8_t*>(data);
+                m_size = header.size;
+            }
+        }
+        ::close(fd);
+        if (m_mapping && !valid()) {
+            spdlog::warn("Discarding the state of the previous plugin instance, the arena is damaged");
+            release();
+        }
+    }
+
+    StateSnapshot(const StateSnapshot&) = delete;
+    StateSnapshot& operator=(const StateSnapshot&) = delete;
+
+    ~StateSnapshot() { release(); }
+
+    bool empty() const { return m_mapping == nullptr; }
+
+    /// Returns the number of reloads the state went through, 0 if there's none
+    std::uint64_t generation() const { return m_mapping ? header().generation : 0; }
+
+    /// Returns the structure stored by the previous instance to be used in place
+    /// @returns nullptr if there's no such section or its layout differs.
+    template <typename T>
+    T* adopt(const SectionId id, const std::uint32_t version) {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= SECTION_ALIGNMENT);
+        const SectionEntry* section = find(id, SectionKind::POD, version);
+        if (!section || section->size != sizeof(T)) {
+            return nullptr;
+        }
+        ++m_adopted;
+        return reinterpret_cast<T*>(m_mapping + section->offset);
+    }
+
+    /// Calls the function with every @ref Record of the section
+    /// @returns false if there's no such section or its version differs.
+    template <typename Fn>
+    bool forEachRecord(const SectionId id, const std::uint32_t version, Fn&& fn) {
+        const SectionEntry* section = find(id, SectionKind::RECORDS, version);
+        if (!section) {
+            return false;
+        }
+        const std::uint8_t* data = m_mapping + section->offset;
+        std::size_t offset = 0;
+        while (offset + sizeof(RecordHeader) <= section->size) {
+            RecordHeader header;
+            std::memcpy(&header, data + offset, sizeof(header));
+            offset += sizeof(header);
+            if (header.size > section->size - offset) {
+                break;
+            }
+            fn(Record{ header.tag, data + offset, header.size });
+            offset += alignUp(header.size, sizeof(header));
+        }
+        ++m_restored;
+        return true;
+    }
+
+    /// Returns the number of sections used in place
+    std::size_t adopted() const { return m_adopted; }
+
+    /// Returns the number of sections rebuilt from their records
+    std::size_t restored() const { return m_restored; }
+
+private:
+    const ArenaHeader& header() const { return *reinterpret_cast<const ArenaHeader*>(m_mapping); }
+
+    const SectionEntry* table() const {
+        return reinterpret_cast<const SectionEntry*>(m_mapping + sizeof(ArenaHeader));
+    }
+
+    bool valid() const {
+        if (header().version != ARENA_VERSION || header().sections > MAX_SECTIONS ||
+            header().checksum != checksum(table(), MAX_SECTIONS * sizeof(SectionEntry))) {
+            return false;
+        }
+        for (std::uint32_t i = 0; i < header().sections; ++i) {
+            const SectionEntry& section = table()[i];
+            if (section.offset < DATA_OFFSET || section.offset % SECTION_ALIGNMENT != 0 ||
+                section.offset > m_size || section.size > m_size - section.offset) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const SectionEntry* find(const SectionId id, const SectionKind kind, const std::uint32_t version) const {
+        if (!m_mapping) {
+            return nullptr;
+        }
+        for (std::uint32_t i = 0; i < header().sections; ++i) {
+            const SectionEntry& section = table()[i];
+            if (section.id != id || section.kind != kind || section.version != version) {
+                continue;
+            }
+            if (section.checksum != checksum(m_mapping + section.offset, section.size)) {
+                spdlog::warn("Checksum of the state section {} doesn't match", static_cast<int>(id));
+                return nullptr;
+            }
+            return &section;
+        }
+        return nullptr;
+    }
+
+    void release() {
+        if (m_mapping) {
+            ::munmap(m_mapping, m_size);
+            m_mapping = nullptr;
+        }
+    }
+
+    std::uint8_t* m_mapping = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_adopted = 0;
+    std::size_t m_restored = 0;
+};
+
+/// Owner of a component's trivially copyable state, which may be replaced by one from a @ref StateSnapshot
+template <typename T>
+class StatePtr {
+public:
+    StatePtr()
+        : m_owned(std::make_unique<T>())
+        , m_state(m_owned.get()) {}
+
+    /// Switches to the given state, which shall outlive this
+    void adopt(T& state) {
+        m_state = &state;
+        m_owned.reset();
+    }
+
+    T& operator*() const { return *m_state; }
+    T* operator->() const { return m_state; }
+
+private:
+    std::unique_ptr<T> m_owned;
+    T* m_state;
+};
+
+} // namespace example::state
+
+#endif // PLUGPP_EXAMPLE_STATE_STATESNAPSHOT_H
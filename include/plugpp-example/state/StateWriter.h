@@ -0,0 +1,152 @@
+#ifndef PLUGPP_EXAMPLE_STATE_STATEWRITER_H
+#define PLUGPP_EXAMPLE_STATE_STATEWRITER_H
+
+#include "plugpp-example/state/StateFormat.h"
+
+#include <spdlog/spdlog.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace example::state {
+
+/// Collects the records of a @ref SectionKind::RECORDS section
+class RecordWriter {
+public:
+    template <typename T>
+    void add(const std::uint32_t tag, const T& payload) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        add(tag, &payload, sizeof(payload));
+    }
+
+    void add(const std::uint32_t tag, const void* data, const std::size_t size) {
+        const RecordHeader header{ tag, static_cast<std::uint32_t>(size) };
+        const std::size_t offset = m_data.size();
+        m_data.resize(offset + sizeof(header) + alignUp(size, sizeof(header)));
+        std::memcpy(m_data.data() + offset, &header, sizeof(header));
+        std::memcpy(m_data.data() + offset + sizeof(header), data, size);
+    }
+
+    const std::vector<std::uint8_t>& data() const { return m_data; }
+
+private:
+    std::vector<std::uint8_t> m_data;
+};
+
+/// Writes the state of the outgoing plugin instance into a new arena
+///
+/// The arena is written with plain writes, sealed against any modification and its descriptor is left in
+/// the environment for the next instance, see @ref StateSnapshot. Failures are logged and make the next
+/// instance start from scratch, they never prevent the plugin from unloading.
+class StateWriter {
+public:
+    explicit StateWriter(const std::uint64_t generation)
+        : m_fd(::memfd_create("plugpp-example-state", MFD_CLOEXEC | MFD_ALLOW_SEALING))
+        , m_generation(generation) {
+        if (m_fd < 0) {
+            spdlog::warn("Can't create the state arena: {}", std::strerror(errno));
+        }
+    }
+
+    StateWriter(const StateWriter&) = delete;
+    StateWriter& operator=(const StateWriter&) = delete;
+
+    ~StateWriter() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    /// Stores the structure to be used in place by an instance with the same layout version
+    template <typename T>
+    void addPod(const SectionId id, const std::uint32_t version, const T& state) {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= SECTION_ALIGNMENT);
+        addSection(id, SectionKind::POD, version, &state, sizeof(state));
+    }
+
+    /// Stores the records, the fallback when the layout of the structure changed
+    void addRecords(const SectionId id, const std::uint32_t version, const RecordWriter& records) {
+        addSection(id, SectionKind::RECORDS, version, records.data().data(), records.data().size());
+    }
+
+    /// Seals the arena and hands it over to the next instance of the plugin
+    bool publish() {
+        if (m_fd < 0) {
+            return false;
+        }
+        ArenaHeader header{};
+        std::memcpy(header.magic, ARENA_MAGIC, sizeof(ARENA_MAGIC));
+        header.version = ARENA_VERSION;
+        header.sections = m_sections;
+        header.size = m_offset;
+        header.generation = m_generation;
+        header.pid = static_cast<std::uint64_t>(::getpid());
+        header.checksum = checksum(m_table, sizeof(m_table));
+
+        constexpr int SEALS = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL;
+        if (::ftruncate(m_fd, static_cast<off_t>(m_offset)) != 0 ||
+            !write(&header, sizeof(header), 0) || !write(m_table, sizeof(m_table), sizeof(header)) ||
+            ::fcntl(m_fd, F_ADD_SEALS, SEALS) != 0) {
+            spdlog::warn("Can't write the state arena: {}", std::strerror(errno));
+            return false;
+        }
+        if (::setenv(ARENA_FD_VARIABLE, std::to_string(m_fd).c_str(), 1) != 0) {
+            return false;
+        }
+        m_fd = -1; // Owned by the next instance now
+        return true;
+    }
+
+private:
+    void addSection(const SectionId id,
+                    const SectionKind kind,
+                    const std::uint32_t version,
+                    const void* data,
+                    const std::size_t size) {
+        if (m_fd < 0 || m_sections == MAX_SECTIONS) {
+            return;
+        }
+        if (!write(data, size, m_offset)) {
+            spdlog::warn("Can't write the state section {}: {}", static_cast<int>(id), std::strerror(errno));
+            return;
+        }
+        m_table[m_sections++] = SectionEntry{ id, kind, version, 0, m_offset, size, checksum(data, size) };
+        m_offset = alignUp(m_offset + size, SECTION_ALIGNMENT);
+    }
+
+    bool write(const void* data, std::size_t size, std::uint64_t offset) {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        while (size > 0) {
+            const ssize_t written = ::pwrite(m_fd, bytes, size, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+            offset += static_cast<std::uint64_t>(written);
+        }
+        return true;
+    }
+
+    int m_fd;
+    const std::uint64_t m_generation;
+    std::uint64_t m_offset = DATA_OFFSET;
+    std::uint32_t m_sections = 0;
+    SectionEntry m_table[MAX_SECTIONS]{};
+};
+
+} // namespace example::state
+
+#endif // PLUGPP_EXAMPLE_STATE_STATEWRITER_H
@@ -0,0 +1,197 @@
+#ifndef PLUGPP_EXAMPLE_STATS_LEADERBOARD_H
+#define PLUGPP_EXAMPLE_STATS_LEADERBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace example::stats {
+
+/// Ranking of the player slots by a score, the highest first
+///
+/// An order-statistic treap over a fixed pool of nodes, one per slot. Every node knows the size of its
+/// subtree, so a score change, the rank of a slot and the slot at a rank all take O(log n), and the top N
+/// are an in-order walk which stops after N nodes - nothing is ever sorted. The treap is trivially copyable
+/// and uses no pointers, so it can be handed over to the next plugin instance as it is. Equal scores are
+/// ranked by the slot number.
+class Leaderboard {
+public:
+    static constexpr std::size_t CAPACITY = 64;
+    static constexpr std::uint8_t NIL = 0xFF;
+
+    /// Ranks the slot with the score, moving it if it's already ranked
+    void set(const int slot, const std::uint64_t score) {
+        erase(slot);
+        Node& node = m_nodes[slot];
+        node.score = score;
+        node.left = NIL;
+        node.right = NIL;
+        node.size = 1;
+        node.ranked = true;
+        m_root = insert(m_root, static_cast<std::uint8_t>(slot));
+    }
+
+    void erase(const int slot) {
+        if (!m_nodes[slot].ranked) {
+            return;
+        }
+        m_root = erase(m_root, static_cast<std::uint8_t>(slot));
+        m_nodes[slot].ranked = false;
+    }
+
+    bool contains(const int slot) const { return m_nodes[slot].ranked; }
+
+    std::uint64_t score(const int slot) const { return m_nodes[slot].score; }
+
+    std::size_t size() const { return sizeOf(m_root); }
+
+    /// Returns the 0-based rank of the slot or -1 if it isn't ranked
+    int rank(const int slot) const {
+        if (!m_nodes[slot].ranked) {
+            return -1;
+        }
+        std::size_t rank = 0;
+        for (std::uint8_t node = m_root; node != slot;) {
+            if (before(static_cast<std::uint8_t>(slot), node)) {
+                node = m_nodes[node].left;
+            } else {
+                rank += sizeOf(m_nodes[node].left) + 1;
+                node = m_nodes[node].right;
+            }
+        }
+        return static_cast<int>(rank + sizeOf(m_nodes[slot].left));
+    }
+
+    /// Returns the slot at the 0-based rank or -1 if there are fewer slots ranked
+    int at(std::size_t rank) const {
+        if (rank >= size()) {
+            return -1;
+        }
+        std::uint8_t node = m_root;
+        for (;;) {
+            const std::size_t left = sizeOf(m_nodes[node].left);
+            if (rank < left) {
+                node = m_nodes[node].left;
+            } else if (rank == left) {
+                return node;
+            } else {
+                rank -= left + 1;
+                node = m_nodes[node].right;
+            }
+        }
+    }
+
+    /// Calls the function with the slots of the best N scores, the best first
+    template <typename Fn>
+    void top(std::size_t count, Fn&& fn) const {
+        std::uint8_t stack[CAPACITY];
+        std::size_t depth = 0;
+        std::uint8_t node = m_root;
+        while (count > 0 && (node != NIL || depth > 0)) {
+            for (; node != NIL; node = m_nodes[node].left) {
+                stack[depth++] = node;
+            }
+            node = stack[--depth];
+            fn(static_cast<int>(node), m_nodes[node].score);
+            --count;
+            node = m_nodes[node].right;
+        }
+    }
+
+private:
+    struct Node {
+        std::uint64_t score;
+        std::uint8_t left;
+        std::uint8_t right;
+        std::uint8_t size;
+        bool ranked;
+    };
+
+    /// Heap priority of the slot's node, fixed and independent of the scores, which keeps the treap balanced
+    static std::uint32_t priority(const std::uint8_t slot) {
+        std::uint32_t h = (slot + 1U) * 0x9E3779B1U;
+        h ^= h >> 15;
+        h *= 0x85EBCA77U;
+        return h ^ (h >> 13);
+    }
+
+    /// Returns true if the slot a is ranked before the slot b
+    bool before(const std::uint8_t a, const std::uint8_t b) const {
+        return m_nodes[a].score != m_nodes[b].score ? m_nodes[a].score > m_nodes[b].score : a < b;
+    }
+
+    std::size_t sizeOf(const std::uint8_t node) const { return node == NIL ? 0 : m_nodes[node].size; }
+
+    void update(const std::uint8_t node) {
+        const std::size_t size = sizeOf(m_nodes[node].left) + sizeOf(m_nodes[node].right) + 1;
+        m_nodes[node].size = static_cast<std::uint8_t>(size);
+    }
+
+    /// Splits the subtree into the nodes ranked before the pivot and the rest
+    void split(const std::uint8_t node, const std::uint8_t pivot, std::uint8_t& left, std::uint8_t& right) {
+        if (node == NIL) {
+            left = NIL;
+            right = NIL;
+        } else if (before(node, pivot)) {
+            split(m_nodes[node].right, pivot, m_nodes[node].right, right);
+            left = node;
+            update(node);
+        } else {
+            split(m_nodes[node].left, pivot, left, m_nodes[node].left);
+            right = node;
+            update(node);
+        }
+    }
+
+    /// Joins two subtrees, all the nodes of the left one are ranked before the ones of the right one
+    std::uint8_t merge(const std::uint8_t left, const std::uint8_t right) {
+        if (left == NIL || right == NIL) {
+            return left == NIL ? right : left;
+        }
+        if (priority(left) > priority(right)) {
+            m_nodes[left].right = merge(m_nodes[left].right, right);
+            update(left);
+            return left;
+        }
+        m_nodes[right].left = merge(left, m_nodes[right].left);
+        update(right);
+        return right;
+    }
+
+    std::uint8_t insert(const std::uint8_t node, const std::uint8_t slot) {
+        if (node == NIL) {
+            return slot;
+        }
+        if (priority(slot) > priority(node)) {
+            split(node, slot, m_nodes[slot].left, m_nodes[slot].right);
+            update(slot);
+            return slot;
+        }
+        if (before(slot, node)) {
+            m_nodes[node].left = insert(m_nodes[node].left, slot);
+        } else {
+            m_nodes[node].right = insert(m_nodes[node].right, slot);
+        }
+        update(node);
+        return node;
+    }
+
+    std::uint8_t erase(const std::uint8_t node, const std::uint8_t slot) {
+        if (node == slot) {
+            return merge(m_nodes[node].left, m_nodes[node].right);
+        }
+        if (before(slot, node)) {
+            m_nodes[node].left = erase(m_nodes[node].left, slot);
+        } else {
+            m_nodes[node].right = erase(m_nodes[node].right, slot);
+        }
+        update(node);
+        return node;
+    }
+
+    Node m_nodes[CAPACITY] = {};
+    std::uint8_t m_root = NIL;
+};
+
+} // namespace example::stats
+
+#endif // PLUGPP_EXAMPLE_STATS_LEADERBOARD_H
@@ -0,0 +1,190 @@
+#ifndef PLUGPP_EXAMPLE_STATS_MATCHSTATS_H
+#define PLUGPP_EXAMPLE_STATS_MATCHSTATS_H
+
+#include "plugpp-example/state/StateSnapshot.h"
+#include "plugpp-example/state/StateWriter.h"
+#include "plugpp-example/stats/Leaderboard.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace example::stats {
+
+constexpr std::string_view MEANS_OF_DEATH_NAMES[] = {
+    "MOD_UNKNOWN",        "MOD_PISTOL_BULLET", "MOD_RIFLE_BULLET",      "MOD_GRENADE",
+    "MOD_GRENADE_SPLASH", "MOD_PROJECTILE",    "MOD_PROJECTILE_SPLASH", "MOD_MELEE",
+    "MOD_HEAD_SHOT",      "MOD_CRUSH",         "MOD_TELEFRAG",          "MOD_FALLING",
+    "MOD_SUICIDE",        "MOD_TRIGGER_HURT",  "MOD_EXPLOSIVE",         "MOD_IMPACT",
+};
+
+constexpr std::string_view HITLOC_NAMES[] = {
+    "HITLOC_NONE",      "HITLOC_HELMET",    "HITLOC_HEAD",      "HITLOC_NECK",
+    "HITLOC_TORSO_UPR", "HITLOC_TORSO_LWR", "HITLOC_R_ARM_UPR", "HITLOC_L_ARM_UPR",
+    "HITLOC_R_ARM_LWR", "HITLOC_L_ARM_LWR", "HITLOC_R_HAND",    "HITLOC_L_HAND",
+    "HITLOC_R_LEG_UPR", "HITLOC_L_LEG_UPR", "HITLOC_R_LEG_LWR", "HITLOC_L_LEG_LWR",
+    "HITLOC_R_FOOT",    "HITLOC_L_FOOT",    "HITLOC_GUN",       "HITLOC_NUM",
+};
+
+/// Means of death of a kill by a shot to the head
+constexpr int MOD_HEAD_SHOT = 8;
+
+/// Kills, deaths and where and with what the players hit, collected kill by kill over a match
+///
+/// The counters are flat arrays indexed by the slot and the weapon or hit location, so recording a kill
+/// touches a handful of counters and the @ref Leaderboard, and reading any of them is a single load. The
+/// leaderboard ranks the players by kills and, for the same kills, by fewer deaths.
+class MatchStats {
+public:
+    static constexpr std::size_t SLOTS = Leaderboard::CAPACITY;
+    static constexpr std::size_t WEAPONS = 128;
+    static constexpr std::size_t HITLOCS = std::size(HITLOC_NAMES) - 1;
+
+    struct State {
+        std::uint32_t kills[SLOTS];
+        std::uint32_t deaths[SLOTS];
+        std::uint32_t headshots[SLOTS];
+        std::uint32_t suicides[SLOTS]; ///< Including the deaths without an attacker.
+        std::uint32_t hitLocations[SLOTS][HITLOCS]; ///< Kills by the hit location of the victim.
+        std::uint32_t weaponKills[SLOTS][WEAPONS];
+        std::uint32_t weaponHeadshots[SLOTS][WEAPONS];
+        Leaderboard leaderboard;
+        std::int32_t startedAt; ///< In milliseconds.
+        std::uint32_t events;   ///< Deaths recorded in the match.
+        char map[64];
+    };
+    static_assert(std::is_trivially_copyable_v<State>);
+
+    /// Layout version of @ref State, shall be bumped whenever the structure changes
+    static constexpr std::uint32_t STATE_VERSION = 1;
+
+    /// Starts a new match, the players in the game stay on the leaderboard with zeroed stats
+    /// @param now The current time in milliseconds.
+    void start(const std::string_view map, const int now) {
+        State& s = *m_state;
+        for (int slot = 0; slot < static_cast<int>(SLOTS); ++slot) {
+            clear(slot);
+            if (s.leaderboard.contains(slot)) {
+                rank(slot);
+            }
+        }
+        s.startedAt = now;
+        s.events = 0;
+        const std::size_t length = std::min(map.size(), sizeof(s.map) - 1);
+        std::memcpy(s.map, map.data(), length);
+        s.map[length] = '\0';
+    }
+
+    /// Starts the stats of a player joining the game
+    void join(const int slot) {
+        if (!valid(slot)) {
+            return;
+        }
+        clear(slot);
+        rank(slot);
+    }
+
+    /// Forgets the stats of a player leaving the game
+    void leave(const int slot) {
+        if (!valid(slot)) {
+            return;
+        }
+        clear(slot);
+        m_state->leaderboard.erase(slot);
+    }
+
+    /// Records a death
+    /// @param attacker Slot of the killer, -1 if the victim died without one.
+    void kill(const int attacker,
+              const int victim,
+              const int weapon,
+              const int meansOfDeath,
+              const int hitLocation) {
+        if (!valid(victim)) {
+            return;
+        }
+        State& s = *m_state;
+        ++s.events;
+        ++s.deaths[victim];
+        if (!valid(attacker) || attacker == victim) {
+            ++s.suicides[victim];
+        } else {
+            const bool headshot = meansOfDeath == MOD_HEAD_SHOT;
+            ++s.kills[attacker];
+            s.headshots[attacker] += headshot ? 1 : 0;
+            if (hitLocation >= 0 && static_cast<std::size_t>(hitLocation) < HITLOCS) {
+                ++s.hitLocations[attacker][hitLocation];
+            }
+            if (weapon >= 0 && static_cast<std::size_t>(weapon) < WEAPONS) {
+                ++s.weaponKills[attacker][weapon];
+                s.weaponHeadshots[attacker][weapon] += headshot ? 1 : 0;
+            }
+            rank(attacker);
+        }
+        rank(victim);
+    }
+
+    const State& state() const { return *m_state; }
+
+    const Leaderboard& leaderboard() const { return m_state->leaderboard; }
+
+    /// Returns the kills per death, the kills when there are no deaths
+    float killDeathRatio(const int slot) const {
+        const State& s = *m_state;
+        const std::uint32_t deaths = std::max<std::uint32_t>(s.deaths[slot], 1);
+        return static_cast<float>(s.kills[slot]) / static_cast<float>(deaths);
+    }
+
+    /// Returns the percentage of the kills which were headshots
+    float headshotPercent(const int slot) const {
+        const State& s = *m_state;
+        if (s.kills[slot] == 0) {
+            return 0.0F;
+        }
+        return 100.0F * static_cast<float>(s.headshots[slot]) / static_cast<float>(s.kills[slot]);
+    }
+
+    static bool valid(const int slot) { return slot >= 0 && static_cast<std::size_t>(slot) < SLOTS; }
+
+    /// Stores the stats of the running match for the next instance of the plugin
+    ///
+    /// There are no records to fall back to, a plugin with another layout starts the match stats over.
+    void save(state::StateWriter& writer) const {
+        writer.addPod(state::SectionId::MATCH_STATS, STATE_VERSION, *m_state);
+    }
+
+    /// Continues the match with the stats of the previous instance of the plugin
+    void restore(state::StateSnapshot& snapshot) {
+        if (State* state = snapshot.adopt<State>(state::SectionId::MATCH_STATS, STATE_VERSION)) {
+            m_state.adopt(*state);
+        }
+    }
+
+private:
+    void clear(const int slot) {
+        State& s = *m_state;
+        s.kills[slot] = 0;
+        s.deaths[slot] = 0;
+        s.headshots[slot] = 0;
+        s.suicides[slot] = 0;
+        std::fill(std::begin(s.hitLocations[slot]), std::end(s.hitLocations[slot]), 0);
+        std::fill(std::begin(s.weaponKills[slot]), std::end(s.weaponKills[slot]), 0);
+        std::fill(std::begin(s.weaponHeadshots[slot]), std::end(s.weaponHeadshots[slot]), 0);
+    }
+
+    /// Moves the slot to its place on the leaderboard
+    void rank(const int slot) {
+        State& s = *m_state;
+        const std::uint64_t score = std::uint64_t{ s.kills[slot] } << 32 | (0xFFFFFFFFU - s.deaths[slot]);
+        s.leaderboard.set(slot, score);
+    }
+
+    state::StatePtr<State> m_state;
+};
+
+} // namespace example::stats
+
+#endif // PLUGPP_EXAMPLE_STATS_MATCHSTATS_H
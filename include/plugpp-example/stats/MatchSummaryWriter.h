@@ -0,0 +1,139 @@
+#ifndef PLUGPP_EXAMPLE_STATS_MATCHSUMMARYWRITER_H
+#define PLUGPP_EXAMPLE_STATS_MATCHSUMMARYWRITER_H
+
+#include "plugpp-example/io/log.h"
+#include "plugpp-example/stats/MatchStats.h"
+#include "plugpp-example/util/WorkerPool.h"
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace example::stats {
+
+/// What's known about a match when it ends, everything the summary needs from the game
+struct MatchSummary {
+    MatchStats::State stats;
+    std::time_t endedAt;
+    int durationMs;
+    std::string names[MatchStats::SLOTS];
+    std::uint64_t playerids[MatchStats::SLOTS];
+    std::vector<std::string> weaponNames; ///< Indexed by the weapon, only the used weapons are named.
+};
+
+/// Writes the summaries of the finished matches into text files on a background thread
+///
+/// The game thread only takes a copy of the stats and the names. Every summary is written into a temporary
+/// file which is renamed into place, so a reader never sees half of one.
+class MatchSummaryWriter {
+public:
+    MatchSummaryWriter()
+        : m_writer(1, 4) {}
+
+    /// Queues the summary to be written into the directory
+    /// @returns false if the queue is full.
+    bool write(std::string directory, std::shared_ptr<const MatchSummary> summary) {
+        const bool posted = m_writer.tryPost([directory = std::move(directory), summary] {
+            std::string map = summary->stats.map;
+            for (char& c : map) {
+                if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') {
+                    c = '_';
+                }
+            }
+            const std::string path = fmt::format("{}/{}-{}.txt", directory, summary->endedAt, map);
+            const std::string temporary = path + ".tmp";
+            const std::string text = format(*summary);
+            std::FILE* file = std::fopen(temporary.c_str(), "w");
+            bool written = file && std::fwrite(text.data(), 1, text.size(), file) == text.size();
+            written = file && std::fclose(file) == 0 && written;
+            if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+                const int error = errno;
+                EXAMPLE_LOG_RATE_LIMITED(warn,
+                                         10,
+                                         60 * 1000,
+                                         "Can't write the match summary '{}': {}",
+                                         path,
+                                         std::strerror(error));
+                std::remove(temporary.c_str());
+                return;
+            }
+            spdlog::info("Wrote the summary of the match on {} to '{}'", summary->stats.map, path);
+        });
+        if (!posted) {
+            EXAMPLE_LOG_RATE_LIMITED(warn,
+                                     10,
+                                     60 * 1000,
+                                     "Match summary queue is full, dropping the summary of {}",
+                                     summary->stats.map);
+        }
+        return posted;
+    }
+
+    /// Formats the summary as tab-separated sections, the players in the order of the leaderboard
+    static std::string format(const MatchSummary& summary) {
+        const MatchStats::State& s = summary.stats;
+        fmt::memory_buffer text;
+        const auto out = std::back_inserter(text);
+        fmt::format_to(
+            out, "map\t{}\nended\t{}\nduration\t{:.1f}\n", s.map, summary.endedAt, summary.durationMs / 1e3);
+
+        fmt::format_to(out, "\n#rank\tplayerid\tkills\tdeaths\theadshots\tsuicides\tname\n");
+        int rank = 0;
+        s.leaderboard.top(MatchStats::SLOTS, [&](const int slot, std::uint64_t) {
+            fmt::format_to(out,
+                           "{}\t{}\t{}\t{}\t{}\t{}\t{}\n",
+                           ++rank,
+                           summary.playerids[slot],
+                           s.kills[slot],
+                           s.deaths[slot],
+                           s.headshots[slot],
+                           s.suicides[slot],
+                           summary.names[slot]);
+        });
+
+        fmt::format_to(out, "\n#weapon\tkills\theadshots\n");
+        for (std::size_t weapon = 0; weapon < MatchStats::WEAPONS; ++weapon) {
+            std::uint32_t kills = 0;
+            std::uint32_t headshots = 0;
+            for (std::size_t slot = 0; slot < MatchStats::SLOTS; ++slot) {
+                kills += s.weaponKills[slot][weapon];
+                headshots += s.weaponHeadshots[slot][weapon];
+            }
+            if (kills > 0) {
+                const bool named =
+                    weapon < summary.weaponNames.size() && !summary.weaponNames[weapon].empty();
+                const std::string name = named ? summary.weaponNames[weapon] : std::to_string(weapon);
+                fmt::format_to(out, "{}\t{}\t{}\n", name, kills, headshots);
+            }
+        }
+
+        fmt::format_to(out, "\n#hitlocation\tkills\n");
+        for (std::size_t location = 0; location < MatchStats::HITLOCS; ++location) {
+            std::uint32_t kills = 0;
+            for (std::size_t slot = 0; slot < MatchStats::SLOTS; ++slot) {
+                kills += s.hitLocations[slot][location];
+            }
+            if (kills > 0) {
+                fmt::format_to(out, "{}\t{}\n", HITLOC_NAMES[location], kills);
+            }
+        }
+        return fmt::to_string(text);
+    }
+
+private:
+    util::WorkerPool m_writer;
+};
+
+} // namespace example::stats
+
+#endif // PLUGPP_EXAMPLE_STATS_MATCHSUMMARYWRITER_H
@@ -0,0 +1,490 @@
+#ifndef PLUGPP_EXAMPLE_TRACE_TRACEFORMAT_H
+#define PLUGPP_EXAMPLE_TRACE_TRACEFORMAT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+/// Binary format of the event traces
+///
+/// A trace file starts with a @ref FileHeader followed by self-contained blocks. Every block starts with a
+/// @ref BlockHeader and holds a sequence of records, each record being the record type, the time elapsed
+/// since the previous record and the fields of the type, all of them LEB128 varints. Move commands are
+/// encoded relative to the previous command of the same slot within the block. As the delta state is reset
+/// at every block, a block can be decoded on its own - a torn or skipped block never corrupts the others.
+///
+/// This header has no dependencies on the server's API, so the tools can decode the traces.
+namespace example::trace {
+
+enum class RecordType : std::uint8_t {
+    SPAWN_SERVER = 1,
+    EXIT_LEVEL,
+    CONNECT,     ///< slot, address
+    AUTH,        ///< slot, playerid, steamid, flags (@ref Event::REJECTED)
+    DISCONNECT,  ///< slot
+    ENTER_WORLD, ///< slot
+    USERINFO,    ///< slot
+    SPAWN,       ///< slot
+    CHAT,        ///< slot, mode, flags (@ref Event::HIDDEN), text
+    KILL,        ///< slot (victim), attacker, weapon, meansOfDeath, hitLocation, damage
+    MOVE,        ///< slot, usercmd
+    UDP_IN,      ///< size, flags (packet class, @ref Event::DROPPED), address
+    UDP_OUT,     ///< size
+    COUNT,
+};
+
+constexpr std::string_view RECORD_NAMES[] = {
+    "",         "spawn_server", "exit_level", "connect", "auth", "disconnect", "enter_world",
+    "userinfo", "spawn",        "chat",       "kill",    "move", "udp_in",     "udp_out",
+};
+static_assert(std::size(RECORD_NAMES) == static_cast<std::size_t>(RecordType::COUNT));
+
+/// Network address of a client or a packet
+struct Address {
+    std::uint8_t family; ///< 4, 6 or 0 if unknown.
+    std::uint16_t port;
+    std::array<std::uint8_t, 16> ip;
+};
+
+/// A decoded record, only the fields of its type are set
+struct Event {
+    static constexpr std::uint8_t REJECTED = 1; ///< AUTH - the client was kicked.
+    static constexpr std::uint8_t HIDDEN = 1;   ///< CHAT - the message was hidden.
+    static constexpr std::uint8_t DROPPED = 8;  ///< UDP_IN - the packet was dropped, low bits are the class.
+
+    /// Longest chat message which is recorded, longer messages are cut
+    static constexpr std::size_t MAX_TEXT = 255;
+
+    RecordType type;
+    std::uint64_t time; ///< Milliseconds, as reported by the server.
+    std::uint8_t slot;
+    std::uint8_t flags;
+    Address address;
+
+    std::uint64_t playerid;
+    std::uint64_t steamid;
+
+    std::int32_t mode;
+    std::string_view text; ///< Points into the encoded block when decoded.
+
+    std::uint8_t attacker;
+    std::uint8_t weapon;
+    std::uint8_t meansOfDeath;
+    std::uint8_t hitLocation;
+    std::int32_t damage;
+
+    struct Command {
+        std::int32_t serverTime;
+        std::int32_t buttons;
+        std::int32_t angles[3]; ///< Decoded as 16-bit angles.
+        std::uint8_t weapon;
+        std::int8_t forwardmove;
+        std::int8_t rightmove;
+    } command;
+
+    std::uint32_t size;
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t blockSize;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+constexpr char FILE_MAGIC[8] = { 'P', 'P', 'X', 'T', 'R', 'A', 'C', 'E' };
+constexpr std::uint32_t VERSION = 1;
+
+struct BlockHeader {
+    static constexpr std::uint32_t MAGIC = 0x4B4C4250; ///< "PBLK"
+
+    std::uint32_t magic;
+    std::uint32_t size; ///< Bytes of the records following the header.
+    std::uint32_t records;
+    std::uint32_t reserved;
+    std::uint64_t baseTime; ///< The time the first record is relative to.
+};
+static_assert(sizeof(BlockHeader) == 24);
+
+/// Upper bound of the encoded size of any record
+constexpr std::size_t MAX_RECORD_SIZE = 160 + Event::MAX_TEXT;
+
+namespace detail {
+
+    inline std::uint8_t* putVarint(std::uint8_t* out, std::uint64_t value) {
+        while (value >= 0x80) {
+            *out++ = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<std::uint8_t>(value);
+        return out;
+    }
+
+    inline std::uint64_t zigzag(const std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    inline std::int64_t unzigzag(const std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    /// Reads a varint, on malformed input sets the cursor past the end
+    inline std::uint64_t getVarint(const std::uint8_t*& in, const std::uint8_t* end) {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; in < end && shift < 64; shift += 7) {
+            const std::uint8_t byte = *in++;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        in = end + 1;
+        return 0;
+    }
+
+    /// Difference of two 16-bit angles wrapped into [-32768, 32767]
+    inline std::int64_t angleDelta(const std::int32_t angle, const std::int32_t previous) {
+        return static_cast<std::int16_t>(static_cast<std::uint16_t>(angle - previous));
+    }
+
+} // namespace detail
+
+/// Encodes records into a block of a caller provided buffer
+class BlockEncoder {
+public:
+    static constexpr std::size_t MAX_SLOTS = 64;
+
+    /// Starts a new block at the beginning of the buffer
+    void begin(std::uint8_t* buffer, const std::size_t capacity, const std::uint64_t baseTime) {
+        m_buffer = buffer;
+        m_capacity = capacity;
+        m_out = buffer + sizeof(BlockHeader);
+        m_records = 0;
+        m_baseTime = m_time = baseTime;
+        m_commands = {};
+    }
+
+    /// Returns true if there's surely room for another record
+    bool hasRoom() const { return m_buffer && m_out + MAX_RECORD_SIZE <= m_buffer + m_capacity; }
+
+    bool empty() const { return m_records == 0; }
+
+    /// Encodes the record, the caller shall check @ref hasRoom() first
+    void append(const Event& event) {
+        using namespace detail;
+        const std::uint64_t time = event.time >= m_time ? event.time : m_time;
+        std::uint8_t* out = m_out;
+        *out++ = static_cast<std::uint8_t>(event.type);
+        out = putVarint(out, time - m_time);
+        m_time = time;
+
+        switch (event.type) {
+        case RecordType::SPAWN_SERVER:
+        case RecordType::EXIT_LEVEL:
+            break;
+        case RecordType::CONNECT:
+            *out++ = event.slot;
+            out = putAddress(out, event.address);
+            break;
+        case RecordType::AUTH:
+            *out++ = event.slot;
+            out = putVarint(out, event.playerid);
+            out = putVarint(out, event.steamid);
+            *out++ = event.flags;
+            break;
+        case RecordType::DISCONNECT:
+        case RecordType::ENTER_WORLD:
+        case RecordType::USERINFO:
+        case RecordType::SPAWN:
+            *out++ = event.slot;
+            break;
+        case RecordType::CHAT: {
+            const std::string_view text = event.text.substr(0, Event::MAX_TEXT);
+            *out++ = event.slot;
+            out = putVarint(out, zigzag(event.mode));
+            *out++ = event.flags;
+            *out++ = static_cast<std::uint8_t>(text.size());
+            std::memcpy(out, text.data(), text.size());
+            out += text.size();
+            break;
+        }
+        case RecordType::KILL:
+            *out++ = event.slot;
+            *out++ = event.attacker;
+            *out++ = event.weapon;
+            *out++ = event.meansOfDeath;
+            *out++ = event.hitLocation;
+            out = putVarint(out, zigzag(event.damage));
+            break;
+        case RecordType::MOVE:
+            out = putCommand(out, event.slot, event.command);
+            break;
+        case RecordType::UDP_IN:
+            out = putVarint(out, event.size);
+            *out++ = event.flags;
+            out = putAddress(out, event.address);
+            break;
+        case RecordType::UDP_OUT:
+            out = putVarint(out, event.size);
+            break;
+        case RecordType::COUNT:
+            return;
+        }
+        m_out = out;
+        ++m_records;
+    }
+
+    /// Writes the block header
+    /// @returns The size of the whole block.
+    std::size_t finish() {
+        BlockHeader header{};
+        header.magic = BlockHeader::MAGIC;
+        header.size = static_cast<std::uint32_t>(m_out - m_buffer - sizeof(BlockHeader));
+        header.records = m_records;
+        header.baseTime = m_baseTime;
+        std::memcpy(m_buffer, &header, sizeof(header));
+        return static_cast<std::size_t>(m_out - m_buffer);
+    }
+
+private:
+    enum CommandField : std::uint8_t {
+        BUTTONS = 1,
+        WEAPON = 2,
+        MOVES = 4,
+    };
+
+    static std::uint8_t* putAddress(std::uint8_t* out, const Address& address) {
+        *out++ = address.family;
+        out = detail::putVarint(out, address.port);
+        const std::size_t size = address.family == 6 ? 16 : address.family == 4 ? 4 : 0;
+        std::memcpy(out, address.ip.data(), size);
+        return out + size;
+    }
+
+    std::uint8_t* putCommand(std::uint8_t* out, const std::uint8_t slot, const Event::Command& command) {
+        using namespace detail;
+        Event::Command& previous = m_commands[slot % MAX_SLOTS];
+        std::uint8_t fields = 0;
+        fields |= command.buttons != previous.buttons ? BUTTONS : 0;
+        fields |= command.weapon != previous.weapon ? WEAPON : 0;
+        fields |= command.forwardmove != previous.forwardmove || command.rightmove != previous.rightmove
+                      ? MOVES
+                      : 0;
+
+        *out++ = slot;
+        *out++ = fields;
+        out = putVarint(out, zigzag(static_cast<std::int64_t>(command.serverTime) - previous.serverTime));
+        for (int i = 0; i < 3; ++i) {
+            out = putVarint(out, zigzag(angleDelta(command.angles[i], previous.angles[i])));
+        }
+        if (fields & BUTTONS) {
+            out = putVarint(out, static_cast<std::uint32_t>(command.buttons ^ previous.buttons));
+        }
+        if (fields & WEAPON) {
+            *out++ = command.weapon;
+        }
+        if (fields & MOVES) {
+            *out++ = static_cast<std::uint8_t>(command.forwardmove);
+            *out++ = static_cast<std::uint8_t>(command.rightmove);
+        }
+        previous = command;
+        return out;
+    }
+
+    std::uint8_t* m_buffer = nullptr;
+    std::size_t m_capacity = 0;
+    std::uint8_t* m_out = nullptr;
+    std::uint32_t m_records = 0;
+    std::uint64_t m_baseTime = 0;
+    std::uint64_t m_time = 0;
+    std::array<Event::Command, MAX_SLOTS> m_commands{};
+
+    friend class BlockDecoder;
+};
+
+/// Decodes the records of a single block
+class BlockDecoder {
+public:
+    /// @param data Start of the block header.
+    /// @param size Bytes available from the start of the block.
+    BlockDecoder(const std::uint8_t* data, const std::size_t size) {
+        if (size < sizeof(BlockHeader)) {
+            return;
+        }
+        BlockHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != BlockHeader::MAGIC || header.size > size - sizeof(BlockHeader)) {
+            return;
+        }
+        m_in = data + sizeof(BlockHeader);
+        m_end = m_in + header.size;
+        m_size = sizeof(BlockHeader) + header.size;
+        m_time = header.baseTime;
+        m_valid = true;
+    }
+
+    /// Returns false if there's no valid block at the given location
+    bool valid() const { return m_valid; }
+
+    /// Returns the size of the whole block
+    std::size_t size() const { return m_size; }
+
+    /// Decodes the next record
+    /// @returns false at the end of the block or if the block is malformed.
+    bool next(Event& event) {
+        using namespace detail;
+        if (!m_valid || m_in >= m_end) {
+            return false;
+        }
+        event = Event{};
+        event.type = static_cast<RecordType>(*m_in++);
+        m_time += getVarint(m_in, m_end);
+        event.time = m_time;
+
+        switch (event.type) {
+        case RecordType::SPAWN_SERVER:
+        case RecordType::EXIT_LEVEL:
+            break;
+        case RecordType::CONNECT:
+            event.slot = getByte();
+            getAddress(event.address);
+            break;
+        case RecordType::AUTH:
+            event.slot = getByte();
+            event.playerid = getVarint(m_in, m_end);
+            event.steamid = getVarint(m_in, m_end);
+            event.flags = getByte();
+            break;
+        case RecordType::DISCONNECT:
+        case RecordType::ENTER_WORLD:
+        case RecordType::USERINFO:
+        case RecordType::SPAWN:
+            event.slot = getByte();
+            break;
+        case RecordType::CHAT: {
+            event.slot = getByte();
+            event.mode = static_cast<std::int32_t>(unzigzag(getVarint(m_in, m_end)));
+            event.flags = getByte();
+            const std::size_t length = getByte();
+            if (m_in + length > m_end) {
+                return fail();
+            }
+            event.text = std::string_view(reinterpret_cast<const char*>(m_in), length);
+            m_in += length;
+            break;
+        }
+        case RecordType::KILL:
+            event.slot = getByte();
+            event.attacker = getByte();
+            event.weapon = getByte();
+            event.meansOfDeath = getByte();
+            event.hitLocation = getByte();
+            event.damage = static_cast<std::int32_t>(unzigzag(getVarint(m_in, m_end)));
+            break;
+        case RecordType::MOVE:
+            getCommand(event);
+            break;
+        case RecordType::UDP_IN:
+            event.size = static_cast<std::uint32_t>(getVarint(m_in, m_end));
+            event.flags = getByte();
+            getAddress(event.address);
+            break;
+        case RecordType::UDP_OUT:
+            event.size = static_cast<std::uint32_t>(getVarint(m_in, m_end));
+            break;
+        default:
+            return fail();
+        }
+        return m_in <= m_end || fail();
+    }
+
+private:
+    std::uint8_t getByte() { return m_in < m_end ? *m_in++ : (++m_in, 0); }
+
+    void getAddress(Address& address) {
+        address.family = getByte();
+        address.port = static_cast<std::uint16_t>(detail::getVarint(m_in, m_end));
+        const std::size_t size = address.family == 6 ? 16 : address.family == 4 ? 4 : 0;
+        if (m_in + size <= m_end) {
+            std::memcpy(address.ip.data(), m_in, size);
+        }
+        m_in += size;
+    }
+
+    void getCommand(Event& event) {
+        using namespace detail;
+        event.slot = getByte();
+        const std::uint8_t fields = getByte();
+        Event::Command& previous = m_commands[event.slot % BlockEncoder::MAX_SLOTS];
+        Event::Command command = previous;
+        const std::int64_t elapsed = unzigzag(getVarint(m_in, m_end));
+        command.serverTime = static_cast<std::int32_t>(previous.serverTime + elapsed);
+        for (int i = 0; i < 3; ++i) {
+            command.angles[i] =
+                static_cast<std::uint16_t>(previous.angles[i] + unzigzag(getVarint(m_in, m_end)));
+        }
+        if (fields & BlockEncoder::BUTTONS) {
+            command.buttons = previous.buttons ^ static_cast<std::int32_t>(getVarint(m_in, m_end));
+        }
+        if (fields & BlockEncoder::WEAPON) {
+            command.weapon = getByte();
+        }
+        if (fields & BlockEncoder::MOVES) {
+            command.forwardmove = static_cast<std::int8_t>(getByte());
+            command.rightmove = static_cast<std::int8_t>(getByte());
+        }
+        previous = command;
+        event.command = command;
+    }
+
+    bool fail() {
+        m_valid = false;
+        return false;
+    }
+
+    const std::uint8_t* m_in = nullptr;
+    const std::uint8_t* m_end = nullptr;
+    std::size_t m_size = 0;
+    std::uint64_t m_time = 0;
+    bool m_valid = false;
+    std::array<Event::Command, BlockEncoder::MAX_SLOTS> m_commands{};
+};
+
+/// Calls the function for every record of the trace file content
+///
+/// Decoding stops at the first invalid block, e.g., the zero-filled tail of a segment which wasn't closed.
+/// @returns false if the data doesn't start with a valid file header.
+template <typename Fn>
+bool forEachEvent(const std::uint8_t* data, const std::size_t size, Fn&& fn) {
+    FileHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != VERSION) {
+        return false;
+    }
+    std::size_t offset = sizeof(header);
+    Event event;
+    while (offset < size) {
+        BlockDecoder block(data + offset, size - offset);
+        if (!block.valid()) {
+            break;
+        }
+        while (block.next(event)) {
+            fn(event);
+        }
+        if (!block.valid()) {
+            break;
+        }
+        offset += block.size();
+    }
+    return true;
+}
+
+} // namespace example::trace
+
+#endif // PLUGPP_EXAMPLE_TRACE_TRACEFORMAT_H
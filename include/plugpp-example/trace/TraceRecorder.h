@@ -0,0 +1,173 @@
+#ifndef PLUGPP_EXAMPLE_TRACE_TRACERECORDER_H
+#define PLUGPP_EXAMPLE_TRACE_TRACERECORDER_H
+
+#include "plugpp-example/trace/TraceWriter.h"
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace example::trace {
+
+/// Records the plugin callbacks into a trace when enabled
+///
+/// Every call is a no-op while the recorder is disabled. Shall only be used from the game thread.
+class TraceRecorder {
+public:
+    /// Starts or stops recording, stopping flushes and closes the trace
+    void setEnabled(const bool enabled, const std::string& path) {
+        if (enabled == static_cast<bool>(m_writer)) {
+            return;
+        }
+        if (enabled) {
+            using Settings = TraceWriter::Settings;
+            m_writer = std::make_unique<TraceWriter>(Settings{ path, SEGMENT_SIZE, MAX_FILES, BLOCK_SIZE });
+            spdlog::info("Recording the trace into '{}'", path);
+        } else {
+            const TraceWriter::Stats stats = m_writer->stats();
+            m_writer.reset();
+            spdlog::info(
+                "Stopped recording the trace, {} records ({} dropped)", stats.records, stats.dropped);
+        }
+    }
+
+    bool enabled() const { return static_cast<bool>(m_writer); }
+
+    /// Hands the recorded events over to the writer at least every second
+    void flush(const int now) {
+        if (m_writer) {
+            m_writer->flush(static_cast<std::uint32_t>(now), FLUSH_INTERVAL_MS);
+        }
+    }
+
+    /// Records an event without any fields but the slot
+    void event(const RecordType type, const int slot = 0) {
+        if (m_writer) {
+            Event e = make(type);
+            e.slot = static_cast<std::uint8_t>(slot);
+            m_writer->record(e);
+        }
+    }
+
+    void connect(const int slot, const netadr_t& from) {
+        if (m_writer) {
+            Event e = make(RecordType::CONNECT);
+            e.slot = static_cast<std::uint8_t>(slot);
+            e.address = toAddress(from);
+            m_writer->record(e);
+        }
+    }
+
+    void auth(const int slot,
+              const std::uint64_t playerid,
+              const std::uint64_t steamid,
+              const bool rejected) {
+        if (m_writer) {
+            Event e = make(RecordType::AUTH);
+            e.slot = static_cast<std::uint8_t>(slot);
+            e.playerid = playerid;
+            e.steamid = steamid;
+            e.flags = rejected ? Event::REJECTED : 0;
+            m_writer->record(e);
+        }
+    }
+
+    void chat(const int slot, const int mode, const std::string_view text, const bool hidden) {
+        if (m_writer) {
+            Event e = make(RecordType::CHAT);
+            e.slot = static_cast<std::uint8_t>(slot);
+            e.mode = mode;
+            e.text = text;
+            e.flags = hidden ? Event::HIDDEN : 0;
+            m_writer->record(e);
+        }
+    }
+
+    void kill(const int victim,
+              const int attacker,
+              const int weapon,
+              const int meansOfDeath,
+              const int hitLocation,
+              const int damage) {
+        if (m_writer) {
+            Event e = make(RecordType::KILL);
+            e.slot = static_cast<std::uint8_t>(victim);
+            e.attacker = static_cast<std::uint8_t>(attacker);
+            e.weapon = static_cast<std::uint8_t>(weapon);
+            e.meansOfDeath = static_cast<std::uint8_t>(meansOfDeath);
+            e.hitLocation = static_cast<std::uint8_t>(hitLocation);
+            e.damage = damage;
+            m_writer->record(e);
+        }
+    }
+
+    void move(const int slot, const usercmd_t& cmd) {
+        if (m_writer) {
+            Event e = make(RecordType::MOVE);
+            e.slot = static_cast<std::uint8_t>(slot);
+            e.command.serverTime = cmd.serverTime;
+            e.command.buttons = cmd.buttons;
+            std::memcpy(e.command.angles, cmd.angles, sizeof(e.command.angles));
+            e.command.weapon = cmd.weapon;
+            e.command.forwardmove = static_cast<std::int8_t>(cmd.forwardmove);
+            e.command.rightmove = static_cast<std::int8_t>(cmd.rightmove);
+            m_writer->record(e);
+        }
+    }
+
+    void udpIn(const netadr_t& from, const int size, const int packetClass, const bool dropped) {
+        if (m_writer) {
+            Event e = make(RecordType::UDP_IN);
+            e.size = static_cast<std::uint32_t>(size);
+            e.flags = static_cast<std::uint8_t>(packetClass | (dropped ? Event::DROPPED : 0));
+            e.address = toAddress(from);
+            m_writer->record(e);
+        }
+    }
+
+    void udpOut(const int size) {
+        if (m_writer) {
+            Event e = make(RecordType::UDP_OUT);
+            e.size = static_cast<std::uint32_t>(size);
+            m_writer->record(e);
+        }
+    }
+
+    TraceWriter::Stats stats() const { return m_writer ? m_writer->stats() : TraceWriter::Stats{}; }
+
+private:
+    static constexpr std::size_t SEGMENT_SIZE = 64 * 1024 * 1024;
+    static constexpr std::size_t MAX_FILES = 10;
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+    static constexpr std::uint64_t FLUSH_INTERVAL_MS = 1000;
+
+    static Event make(const RecordType type) {
+        Event e{};
+        e.type = type;
+        e.time = static_cast<std::uint32_t>(Plugin_Milliseconds());
+        return e;
+    }
+
+    static Address toAddress(const netadr_t& address) {
+        Address a{};
+        a.port = address.port;
+        if (address.type == NA_IP) {
+            a.family = 4;
+            std::memcpy(a.ip.data(), address.ip, 4);
+        } else if (address.type == NA_IP6) {
+            a.family = 6;
+            std::memcpy(a.ip.data(), address.ip6, 16);
+        }
+        return a;
+    }
+
+    std::unique_ptr<TraceWriter> m_writer;
+};
+
+} // namespace example::trace
+
+#endif // PLUGPP_EXAMPLE_TRACE_TRACERECORDER_H
@@ -0,0 +1,300 @@
+#ifndef PLUGPP_EXAMPLE_TRACE_TRACEWRITER_H
+#define PLUGPP_EXAMPLE_TRACE_TRACEWRITER_H
+
+#include "plugpp-example/trace/TraceFormat.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace example::trace {
+
+/// Writes the trace into rotated segment files
+///
+/// Records are encoded on the calling thread into one of two block buffers. A full block (or one flushed by
+/// @ref flush()) is handed over to a background thread which copies it into the current segment - a file of
+/// a fixed size mmap'ed in whole - while the caller keeps filling the other buffer. If the background thread
+/// still hasn't finished the previous block when the next one is full, records are dropped rather than
+/// blocking the caller.
+///
+/// When a segment is full, it's truncated to its used size and the segments are rotated the same way the
+/// rotating log files are: `example.trace` becomes `example.1.trace`, `example.1.trace` becomes
+/// `example.2.trace` and so on up to the maximum number of files. The segment of a previous run is rotated
+/// on start.
+class TraceWriter {
+public:
+    struct Settings {
+        std::string path;
+        std::size_t segmentSize;
+        std::size_t maxFiles;
+        std::size_t blockSize;
+    };
+
+    struct Stats {
+        std::uint64_t records;
+        std::uint64_t dropped;
+        std::uint64_t blocks;
+        std::uint64_t bytes;
+        std::uint64_t segments;
+    };
+
+    explicit TraceWriter(Settings settings)
+        : m_settings(std::move(settings)) {
+        const std::size_t minimum = sizeof(FileHeader) + sizeof(BlockHeader) + MAX_RECORD_SIZE;
+        m_settings.blockSize = std::max(m_settings.blockSize, minimum);
+        m_settings.segmentSize = std::max(m_settings.segmentSize, sizeof(FileHeader) + m_settings.blockSize);
+        m_settings.maxFiles = std::max<std::size_t>(m_settings.maxFiles, 1);
+        for (auto& buffer : m_buffers) {
+            buffer = std::make_unique<std::uint8_t[]>(m_settings.blockSize);
+        }
+        m_thread = std::thread([this] { run(); });
+    }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /// Writes the buffered records and closes the segment
+    ~TraceWriter() noexcept {
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_pendingSize == 0; });
+        }
+        flush();
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    /// Encodes the record
+    void record(const Event& event) {
+        if (!m_encoder.empty() && !m_encoder.hasRoom() && !handOff()) {
+            ++m_dropped;
+            return;
+        }
+        if (m_encoder.empty()) {
+            m_encoder.begin(m_buffers[m_active].get(), m_settings.blockSize, event.time);
+            m_blockStart = event.time;
+        }
+        m_encoder.append(event);
+        ++m_records;
+        ++m_blockRecords;
+    }
+
+    /// Hands the block over to the background thread if it's older than the given age
+    void flush(const std::uint64_t now, const std::uint64_t maxAge) {
+        if (!m_encoder.empty() && now - m_blockStart >= maxAge) {
+            handOff();
+        }
+    }
+
+    /// Hands the block over to the background thread, unless it's busy
+    void flush() {
+        if (!m_encoder.empty()) {
+            handOff();
+        }
+    }
+
+    /// Shall be called from the thread recording the events
+    Stats stats() const {
+        std::lock_guard lock(m_mutex);
+        return { m_records, m_dropped + m_lost, m_blocks, m_bytes, m_segments };
+    }
+
+private:
+    /// Passes the block to the background thread and starts a new one in the other buffer
+    /// @returns false if the background thread hasn't finished the previous block yet.
+    bool handOff() {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_pendingSize != 0) {
+                return false;
+            }
+            m_pendingSize = m_encoder.finish();
+            m_pendingRecords = m_blockRecords;
+            m_pending = m_active;
+        }
+        m_blockRecords = 0;
+        m_cv.notify_one();
+        m_active ^= 1;
+        m_encoder.begin(m_buffers[m_active].get(), m_settings.blockSize, 0);
+        return true;
+    }
+
+    void run() {
+        for (;;) {
+            std::size_t size = 0;
+            std::size_t index = 0;
+            {
+                std::unique_lock lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_stopping || m_pendingSize != 0; });
+                if (m_pendingSize == 0) {
+                    break;
+                }
+                size = m_pendingSize;
+                index = m_pending;
+            }
+            const bool written = write(m_buffers[index].get(), size);
+            {
+                std::lock_guard lock(m_mutex);
+                m_pendingSize = 0;
+                if (written) {
+                    ++m_blocks;
+                    m_bytes += size;
+                } else {
+                    m_lost += m_pendingRecords;
+                }
+            }
+            m_cv.notify_all();
+        }
+        closeSegment();
+    }
+
+    /// @returns false if the block was lost because no segment could be opened.
+    bool write(const std::uint8_t* block, const std::size_t size) {
+        if (m_segment && m_offset + size > m_settings.segmentSize) {
+            closeSegment();
+            rotate();
+        }
+        if (!m_segment && !openSegment()) {
+            return false;
+        }
+        std::memcpy(m_segment + m_offset, block, size);
+        m_offset += size;
+        ::msync(m_segment, m_offset, MS_ASYNC);
+        return true;
+    }
+
+    bool openSegment() {
+        if (m_firstSegment) {
+            m_firstSegment = false;
+            createDirectories();
+            rotate();
+        }
+        m_fd = ::open(m_settings.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (m_fd < 0) {
+            spdlog::error("Failed to open the trace '{}': {}", m_settings.path, std::strerror(errno));
+            return false;
+        }
+        if (::ftruncate(m_fd, static_cast<off_t>(m_settings.segmentSize)) != 0) {
+            spdlog::error("Failed to allocate the trace '{}': {}", m_settings.path, std::strerror(errno));
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        void* data = ::mmap(nullptr, m_settings.segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED) {
+            spdlog::error("Failed to map the trace '{}': {}", m_settings.path, std::strerror(errno));
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        m_segment = static_cast<std::uint8_t*>(data);
+
+        FileHeader header{};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = VERSION;
+        header.blockSize = static_cast<std::uint32_t>(m_settings.blockSize);
+        std::memcpy(m_segment, &header, sizeof(header));
+        m_offset = sizeof(header);
+
+        std::lock_guard lock(m_mutex);
+        ++m_segments;
+        return true;
+    }
+
+    void closeSegment() {
+        if (!m_segment) {
+            return;
+        }
+        ::munmap(m_segment, m_settings.segmentSize);
+        if (::ftruncate(m_fd, static_cast<off_t>(m_offset)) != 0) {
+            spdlog::warn("Failed to truncate the trace '{}': {}", m_settings.path, std::strerror(errno));
+        }
+        ::close(m_fd);
+        m_segment = nullptr;
+        m_fd = -1;
+    }
+
+    /// Returns the name of the rotated file with the given index, e.g., `trace/example.1.trace`
+    std::string fileName(const std::size_t index) const {
+        const std::string& path = m_settings.path;
+        if (index == 0) {
+            return path;
+        }
+        const std::size_t slash = path.find_last_of('/');
+        const std::size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos || dot == 0 || (slash != std::string::npos && dot < slash + 2)) {
+            return path + "." + std::to_string(index);
+        }
+        return path.substr(0, dot) + "." + std::to_string(index) + path.substr(dot);
+    }
+
+    void rotate() {
+        // The current file and maxFiles - 1 rotated ones are kept
+        for (std::size_t i = m_settings.maxFiles - 1; i > 0; --i) {
+            const std::string from = fileName(i - 1);
+            if (::access(from.c_str(), F_OK) == 0) {
+                std::rename(from.c_str(), fileName(i).c_str());
+            }
+        }
+    }
+
+    void createDirectories() const {
+        const std::string& path = m_settings.path;
+        for (std::size_t slash = path.find('/', 1); slash != std::string::npos;
+             slash = path.find('/', slash + 1)) {
+            ::mkdir(path.substr(0, slash).c_str(), 0755);
+        }
+    }
+
+    Settings m_settings;
+
+    // Owned by the caller's thread
+    std::unique_ptr<std::uint8_t[]> m_buffers[2];
+    std::size_t m_active = 0;
+    BlockEncoder m_encoder;
+    std::uint64_t m_blockStart = 0;
+    std::uint64_t m_records = 0;
+    std::uint64_t m_dropped = 0;
+    std::uint64_t m_blockRecords = 0;
+
+    // Owned by the background thread
+    std::uint8_t* m_segment = nullptr;
+    int m_fd = -1;
+    std::size_t m_offset = 0;
+    bool m_firstSegment = true;
+
+    // Shared, guarded by the mutex
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::size_t m_pending = 0;
+    std::size_t m_pendingSize = 0;
+    std::uint64_t m_pendingRecords = 0;
+    std::uint64_t m_lost = 0; ///< Records of the blocks which couldn't be written.
+    bool m_stopping = false;
+    std::uint64_t m_blocks = 0;
+    std::uint64_t m_bytes = 0;
+    std::uint64_t m_segments = 0;
+
+    std::thread m_thread;
+};
+
+} // namespace example::trace
+
+#endif // PLUGPP_EXAMPLE_TRACE_TRACEWRITER_H
@@ -0,0 +1,256 @@
+#ifndef PLUGPP_EXAMPLE_USERINFO_USERINFO_H
+#define PLUGPP_EXAMPLE_USERINFO_USERINFO_H
+
+#include "plugpp-example/util/FixedVector.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace example::userinfo {
+
+/// Keys of the userinfo which are interned, so looking them up doesn't compare any strings
+enum class Key : std::uint8_t {
+    NAME,
+    RATE,
+    SNAPS,
+    CL_PUNKBUSTER,
+    CL_ANONYMOUS,
+    CL_VOICE,
+    CL_WWWDOWNLOAD,
+    CG_PREDICTITEMS,
+    PROTOCOL,
+    QPORT,
+    CHALLENGE,
+    XVER,
+    COUNT,
+    OTHER = COUNT, ///< Any key which isn't interned.
+};
+
+constexpr std::string_view KEY_NAMES[] = {
+    "name",           "rate",            "snaps",    "cl_punkbuster", "cl_anonymous", "cl_voice",
+    "cl_wwwDownload", "cg_predictItems", "protocol", "qport",         "challenge",    "xver",
+};
+static_assert(std::size(KEY_NAMES) == static_cast<std::size_t>(Key::COUNT));
+
+namespace detail {
+
+    /// The engine compares the userinfo keys case-insensitively
+    inline bool equalsIgnoreCase(const std::string_view a, const std::string_view b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            // Folds the ASCII letters, the keys never contain any of the characters this maps onto them
+            if ((a[i] | 0x20) != (b[i] | 0x20)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace detail
+
+/// Returns the interned key with the name or @ref Key::OTHER
+inline Key intern(const std::string_view name) {
+    for (std::size_t i = 0; i < std::size(KEY_NAMES); ++i) {
+        if (detail::equalsIgnoreCase(name, KEY_NAMES[i])) {
+            return static_cast<Key>(i);
+        }
+    }
+    return Key::OTHER;
+}
+
+/// A userinfo string split into its key-value pairs
+///
+/// Userinfo is a backslash separated key-value list, e.g., `\name\Player\rate\25000\snaps\20`. The string is
+/// copied into a fixed-size buffer and the pairs are kept as offsets into it, so parsing never allocates and
+/// the object is trivially copyable.
+class Userinfo {
+public:
+    static constexpr std::size_t MAX_LENGTH = 1024; ///< MAX_INFO_STRING of the engine.
+    static constexpr std::size_t MAX_KEYS = 64;
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+    /// Copies and splits the userinfo string
+    /// @returns false if the string is longer than @ref MAX_LENGTH or has more than @ref MAX_KEYS keys, the
+    /// pairs within the limits are still available.
+    bool parse(const std::string_view text) {
+        clear();
+        m_complete = text.size() <= MAX_LENGTH;
+        m_length = static_cast<std::uint16_t>(std::min(text.size(), MAX_LENGTH));
+        std::memcpy(m_text, text.data(), m_length);
+
+        std::size_t pos = m_length > 0 && m_text[0] == '\\' ? 1 : 0;
+        while (pos < m_length) {
+            const std::size_t nameEnd = next(pos);
+            const std::size_t valueStart = std::min<std::size_t>(nameEnd + 1, m_length);
+            const std::size_t valueEnd = next(valueStart);
+            if (nameEnd > pos) {
+                Entry entry;
+                entry.nameOffset = static_cast<std::uint16_t>(pos);
+                entry.nameLength = static_cast<std::uint16_t>(nameEnd - pos);
+                entry.valueOffset = static_cast<std::uint16_t>(valueStart);
+                entry.valueLength = static_cast<std::uint16_t>(valueEnd - valueStart);
+                entry.key = userinfo::intern(name(entry));
+                if (!m_entries.push_back(entry)) {
+                    m_complete = false;
+                    break;
+                }
+                // Like the engine, the first occurrence of a duplicated key wins
+                if (entry.key != Key::OTHER) {
+                    auto& index = m_index[static_cast<std::size_t>(entry.key)];
+                    index = index == 0 ? static_cast<std::uint8_t>(m_entries.size()) : index;
+                }
+            }
+            pos = valueEnd + 1;
+        }
+        return m_complete;
+    }
+
+    void clear() {
+        m_length = 0;
+        m_complete = true;
+        m_entries.clear();
+        m_index.fill(0);
+    }
+
+    std::string_view text() const { return { m_text, m_length }; }
+    bool complete() const { return m_complete; }
+
+    /// Returns the number of key-value pairs
+    std::size_t size() const { return m_entries.size(); }
+    Key key(const std::size_t i) const { return m_entries[i].key; }
+    std::string_view name(const std::size_t i) const { return name(m_entries[i]); }
+    std::string_view value(const std::size_t i) const { return value(m_entries[i]); }
+
+    /// Returns the index of the pair with the key or @ref NPOS
+    std::size_t find(const Key key) const {
+        if (key == Key::OTHER) {
+            return NPOS;
+        }
+        return static_cast<std::size_t>(m_index[static_cast<std::size_t>(key)]) - 1;
+    }
+
+    /// Returns the index of the pair with the key or @ref NPOS
+    std::size_t find(const std::string_view name) const {
+        if (const Key key = userinfo::intern(name); key != Key::OTHER) {
+            return find(key);
+        }
+        for (std::size_t i = 0; i < m_entries.size(); ++i) {
+            if (m_entries[i].key == Key::OTHER && detail::equalsIgnoreCase(this->name(i), name)) {
+                return i;
+            }
+        }
+        return NPOS;
+    }
+
+    /// Returns the value of the key or an empty string if there is no such key
+    std::string_view get(const Key key) const {
+        const std::size_t i = find(key);
+        return i == NPOS ? std::string_view() : value(i);
+    }
+
+    /// Returns the value of the key as a number, if there is such key and its value is a number
+    std::optional<int> getInt(const Key key) const { return toInt(get(key)); }
+
+    static std::optional<int> toInt(const std::string_view text) {
+        int value = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    struct Entry {
+        std::uint16_t nameOffset;
+        std::uint16_t nameLength;
+        std::uint16_t valueOffset;
+        std::uint16_t valueLength;
+        Key key;
+    };
+
+    std::size_t next(const std::size_t pos) const {
+        const void* separator = std::memchr(m_text + pos, '\\', m_length - pos);
+        return separator ? static_cast<std::size_t>(static_cast<const char*>(separator) - m_text) : m_length;
+    }
+
+    std::string_view name(const Entry& entry) const {
+        return { m_text + entry.nameOffset, entry.nameLength };
+    }
+
+    std::string_view value(const Entry& entry) const {
+        return { m_text + entry.valueOffset, entry.valueLength };
+    }
+
+    char m_text[MAX_LENGTH];
+    std::uint16_t m_length = 0;
+    bool m_complete = true;
+    util::FixedVector<Entry, MAX_KEYS> m_entries;
+    std::array<std::uint8_t, static_cast<std::size_t>(Key::COUNT)> m_index{}; ///< Index + 1 of every key.
+};
+
+enum class ChangeType : std::uint8_t {
+    ADDED,
+    CHANGED,
+    REMOVED,
+};
+
+/// A key whose value differs between two userinfos
+struct Change {
+    Key key;
+    ChangeType type;
+    std::string_view name;
+    std::string_view oldValue; ///< Empty for an added key.
+    std::string_view newValue; ///< Empty for a removed key.
+};
+
+using Changes = util::FixedVector<Change, 2 * Userinfo::MAX_KEYS>;
+
+/// Collects the keys which differ between the two userinfos
+///
+/// Clients send the keys in the same order every time, so the pairs are first matched by their position and
+/// only looked up when the order differs. The changes refer to the strings of both userinfos.
+inline void diff(const Userinfo& previous, const Userinfo& current, Changes& changes) {
+    changes.clear();
+    if (previous.text() == current.text()) {
+        return;
+    }
+    static_assert(Userinfo::MAX_KEYS <= 64);
+    std::uint64_t matched = 0;
+    for (std::size_t i = 0; i < current.size(); ++i) {
+        std::size_t j = i;
+        if (j >= previous.size() || current.key(i) != previous.key(j) ||
+            !detail::equalsIgnoreCase(current.name(i), previous.name(j))) {
+            j = current.key(i) == Key::OTHER ? previous.find(current.name(i)) : previous.find(current.key(i));
+        }
+        if (j == Userinfo::NPOS) {
+            changes.push_back({ current.key(i), ChangeType::ADDED, current.name(i), {}, current.value(i) });
+            continue;
+        }
+        matched |= std::uint64_t{ 1 } << j;
+        if (current.value(i) != previous.value(j)) {
+            changes.push_back({ current.key(i),
+                                ChangeType::CHANGED,
+                                current.name(i),
+                                previous.value(j),
+                                current.value(i) });
+        }
+    }
+    for (std::size_t j = 0; j < previous.size(); ++j) {
+        if (!(matched & (std::uint64_t{ 1 } << j))) {
+            changes.push_back(
+                { previous.key(j), ChangeType::REMOVED, previous.name(j), previous.value(j), {} });
+        }
+    }
+}
+
+} // namespace example::userinfo
+
+#endif // PLUGPP_EXAMPLE_USERINFO_USERINFO_H
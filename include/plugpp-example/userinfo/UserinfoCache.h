@@ -0,0 +1,105 @@
+#ifndef PLUGPP_EXAMPLE_USERINFO_USERINFOCACHE_H
+#define PLUGPP_EXAMPLE_USERINFO_USERINFOCACHE_H
+
+#include "plugpp-example/state/StateSnapshot.h"
+#include "plugpp-example/state/StateWriter.h"
+#include "plugpp-example/userinfo/Userinfo.h"
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace example::userinfo {
+
+/// The parsed userinfo of every client
+///
+/// Every slot keeps its current and its previous userinfo, so an update parses the new string into the older
+/// buffer and reports the changed keys without copying or allocating anything.
+class UserinfoCache {
+public:
+    static constexpr int SLOTS = 64;
+
+    /// Layout version of the cached userinfos, shall be bumped whenever @ref Userinfo changes
+    static constexpr std::uint32_t STATE_VERSION = 1;
+
+    /// Parses the client's userinfo
+    /// @returns The keys which changed since the previous update of the slot, all the keys are added after a
+    /// @ref reset(). The changes refer to the cached strings and stay valid until the next update.
+    const Changes& update(const int slot, const std::string_view text) {
+        m_changes.clear();
+        if (slot < 0 || slot >= SLOTS) {
+            return m_changes;
+        }
+        Slot& s = m_state->slots[slot];
+        s.current ^= 1;
+        s.infos[s.current].parse(text);
+        diff(s.infos[s.current ^ 1], s.infos[s.current], m_changes);
+        return m_changes;
+    }
+
+    /// Forgets the userinfo of the client, e.g., when the slot gets free
+    void reset(const int slot) {
+        if (slot >= 0 && slot < SLOTS) {
+            Slot& s = m_state->slots[slot];
+            s.infos[s.current].clear();
+        }
+    }
+
+    /// Returns the userinfo of the client as of the last update
+    const Userinfo& get(const int slot) const {
+        const Slot& s = m_state->slots[slot];
+        return s.infos[s.current];
+    }
+
+    /// Stores the userinfos for the next instance of the plugin
+    void save(state::StateWriter& writer) const {
+        writer.addPod(state::SectionId::USERINFO, STATE_VERSION, *m_state);
+        state::RecordWriter records;
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            const std::string_view text = get(slot).text();
+            if (!text.empty()) {
+                records.add(static_cast<std::uint32_t>(slot), text.data(), text.size());
+            }
+        }
+        writer.addRecords(state::SectionId::USERINFO, RECORDS_VERSION, records);
+    }
+
+    /// Continues with the userinfos of the previous instance of the plugin, so the next update of a client
+    /// reports only what changed since then
+    ///
+    /// The userinfos are used in place when their layout didn't change, otherwise the texts are parsed anew.
+    void restore(state::StateSnapshot& snapshot) {
+        if (State* state = snapshot.adopt<State>(state::SectionId::USERINFO, STATE_VERSION)) {
+            m_state.adopt(*state);
+            return;
+        }
+        snapshot.forEachRecord(
+            state::SectionId::USERINFO, RECORDS_VERSION, [this](const state::Record& record) {
+                if (record.tag < static_cast<std::uint32_t>(SLOTS)) {
+                    Slot& s = m_state->slots[record.tag];
+                    s.infos[s.current].parse({ static_cast<const char*>(record.data), record.size });
+                }
+            });
+    }
+
+private:
+    /// Version of the records written by @ref save(), the userinfo text of every slot tagged with the slot
+    static constexpr std::uint32_t RECORDS_VERSION = 1;
+
+    struct Slot {
+        Userinfo infos[2];
+        int current = 0;
+    };
+
+    struct State {
+        Slot slots[SLOTS];
+    };
+    static_assert(std::is_trivially_copyable_v<State>);
+
+    state::StatePtr<State> m_state;
+    Changes m_changes;
+};
+
+} // namespace example::userinfo
+
+#endif // PLUGPP_EXAMPLE_USERINFO_USERINFOCACHE_H
@@ -0,0 +1,51 @@
+#ifndef PLUGPP_EXAMPLE_UTIL_FIXEDVECTOR_H
+#define PLUGPP_EXAMPLE_UTIL_FIXEDVECTOR_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace example::util {
+
+/// Vector with the capacity fixed at compile time and the elements stored inline
+///
+/// Meant for small trivial elements, it never allocates and stays trivially copyable when the element is.
+template <typename T, std::size_t N>
+class FixedVector {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>);
+
+public:
+    static constexpr std::size_t CAPACITY = N;
+
+    /// Appends the element
+    /// @returns false if the vector is full.
+    bool push_back(const T& value) {
+        if (m_size == N) {
+            return false;
+        }
+        m_data[m_size++] = value;
+        return true;
+    }
+
+    void clear() { m_size = 0; }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool full() const { return m_size == N; }
+
+    T& operator[](const std::size_t i) { return m_data[i]; }
+    const T& operator[](const std::size_t i) const { return m_data[i]; }
+
+    T* begin() { return m_data.data(); }
+    T* end() { return m_data.data() + m_size; }
+    const T* begin() const { return m_data.data(); }
+    const T* end() const { return m_data.data() + m_size; }
+
+private:
+    std::array<T, N> m_data{};
+    std::size_t m_size = 0;
+};
+
+} // namespace example::util
+
+#endif // PLUGPP_EXAMPLE_UTIL_FIXEDVECTOR_H
@@ -0,0 +1,102 @@
+#ifndef PLUGPP_EXAMPLE_UTIL_WORKERPOOL_H
+#define PLUGPP_EXAMPLE_UTIL_WORKERPOOL_H
+
+#include "plugpp-example/io/log.h"
+
+#include <spdlog/spdlog.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace example::util {
+
+/// Fixed set of worker threads executing tasks from a bounded queue
+///
+/// Posting never blocks - when the queue is full, the task is rejected and it's up to the caller to skip or
+/// retry it later. The destructor finishes the already queued tasks and joins the threads, so the pool shall
+/// be destroyed before the plugin gets unloaded.
+class WorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    WorkerPool(const std::size_t threads, const std::size_t capacity)
+        : m_capacity(capacity) {
+        m_threads.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            m_threads.emplace_back([this] { run(); });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() noexcept {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    /// Queues the task for execution
+    /// @returns true if the task was queued, false if the queue is full.
+    bool tryPost(Task task) {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_stopping || m_queue.size() >= m_capacity) {
+                return false;
+            }
+            m_queue.emplace_back(std::move(task));
+        }
+        m_cv.notify_one();
+        return true;
+    }
+
+    /// Returns the number of tasks waiting for a worker
+    std::size_t pending() const {
+        std::lock_guard lock(m_mutex);
+        return m_queue.size();
+    }
+
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    void run() {
+        for (;;) {
+            Task task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty()) {
+                    return;
+                }
+                task = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            try {
+                task();
+            } catch (const std::exception& e) {
+                EXAMPLE_LOG_RATE_LIMITED(err, 10, 10 * 1000, "Worker task failed: {}", e.what());
+            }
+        }
+    }
+
+    const std::size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Task> m_queue;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace example::util
+
+#endif // PLUGPP_EXAMPLE_UTIL_WORKERPOOL_H
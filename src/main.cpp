@@ -1,9 +1,9 @@
 #include "plugpp-example/ExamplePlugin.h"
+#include "plugpp-example/io/log.h"
 #include "plugpp-example/io/print.h"
 #include "plugpp-example/literals.h"
 
 #include <cod4-plugpp/PluginEntry.hpp>
-#include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/spdlog.h>
 
@@ -11,7 +11,8 @@ using namespace example::memory_literals;
 
 /// Sink logging messages into the server's console
 ///
-/// The format of the logged message is `[<log severity>] <message>`
+/// The format of the logged message is `[<log severity>] <message>`. The lines are queued and printed by the
+/// game thread, @see example::io::ConsoleQueue.
 template <typename Mutex>
 class ConsoleSink : public spdlog::sinks::base_sink<Mutex> {
 public:
@@ -32,19 +33,17 @@ protected:
 void pluginMain(plugpp::PluginEntry& entry) {
     static constexpr std::size_t MAX_SIZE = 50_MiB;
     static constexpr std::size_t MAX_FILES = 10;
+    static constexpr std::size_t LOG_QUEUE_SIZE = 8192;
     using RotatingFileSink = spdlog::sinks::rotating_file_sink_mt;
 
+    // The sinks are only used by the logging thread, their mutexes matter just after the logging is stopped
     std::vector<spdlog::sink_ptr> sinks;
     sinks.emplace_back(std::make_shared<ConsoleSink<std::mutex>>())->set_level(spdlog::level::info);
     sinks.emplace_back(std::make_shared<RotatingFileSink>("log/example.log", MAX_SIZE, MAX_FILES))
         ->set_level(spdlog::level::debug);
 
-    auto logger = std::make_shared<spdlog::logger>(
-        "example", std::make_move_iterator(std::begin(sinks)), std::make_move_iterator(std::end(sinks)));
-    logger->set_level(spdlog::level::trace);
-
-    spdlog::set_default_logger(std::move(logger));
-    spdlog::flush_every(std::chrono::seconds(30));
+    // Flushed by the plugin's scheduler and stopped by its destructor
+    example::io::startLogging("example", std::move(sinks), LOG_QUEUE_SIZE);
 
     entry.registerPlugin<example::ExamplePlugin>("Hello, plugin!");
 }
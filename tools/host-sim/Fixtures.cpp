@@ -0,0 +1,92 @@
+#include "Fixtures.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace host {
+
+namespace {
+
+    struct Fixtures {
+        client_t clients[SLOTS];
+        gentity_t entities[SLOTS];
+        gclient_t gclients[SLOTS];
+        std::uint64_t dropped = 0;
+    };
+
+    Fixtures& fixtures() {
+        // Heap allocated and zero-initialized like the server's static arrays
+        static const std::unique_ptr<Fixtures> instance = std::make_unique<Fixtures>();
+        return *instance;
+    }
+
+} // namespace
+
+client_t& client(const int num) {
+    return fixtures().clients[num];
+}
+
+gentity_t& entity(const int num) {
+    return fixtures().entities[num];
+}
+
+void connectClient(const int num, const std::string_view name) {
+    Fixtures& f = fixtures();
+    client_t& cl = f.clients[num];
+    std::memset(&cl, 0, sizeof(cl));
+    cl.state = CS_CONNECTED;
+    cl.netchan.remoteAddress.type = NA_IP;
+    cl.netchan.remoteAddress.port = static_cast<unsigned short>(28960 + num);
+    cl.netchan.remoteAddress.ip[0] = 10;
+    cl.netchan.remoteAddress.ip[2] = static_cast<byte>(num);
+    cl.netchan.remoteAddress.ip[3] = 1;
+    const int length = static_cast<int>(std::min(name.size(), sizeof(cl.name) - 1));
+    std::memcpy(cl.name, name.data(), static_cast<std::size_t>(length));
+    std::snprintf(cl.userinfo,
+                  sizeof(cl.userinfo),
+                  "\\name\\%.*s\\rate\\25000\\snaps\\20\\cl_punkbuster\\0\\protocol\\6",
+                  length,
+                  name.data());
+    cl.playerid = 0x0110000100000000ULL + static_cast<std::uint64_t>(num);
+    cl.steamid = 0x0110000200000000ULL + static_cast<std::uint64_t>(num);
+    cl.lastPacketTime = milliseconds();
+
+    gentity_t& ent = f.entities[num];
+    ent.s.number = num;
+    ent.client = &f.gclients[num];
+    ent.client->ps.clientNum = num;
+    cl.gentity = &ent;
+}
+
+void freeClient(const int num) {
+    fixtures().clients[num].state = CS_FREE;
+}
+
+void* clientForNum(const int num) {
+    return num >= 0 && num < SLOTS ? &fixtures().clients[num] : nullptr;
+}
+
+int clientNumFor(const void* cl) {
+    const client_t* clients = fixtures().clients;
+    const auto* c = static_cast<const client_t*>(cl);
+    return c >= clients && c < clients + SLOTS ? static_cast<int>(c - clients) : -1;
+}
+
+void dropClient(const int num, const char* reason) {
+    if (num < 0 || num >= SLOTS) {
+        return;
+    }
+    ++fixtures().dropped;
+    freeClient(num);
+    char line[256];
+    std::snprintf(line, sizeof(line), "Dropped client %d: %s\n", num, reason ? reason : "");
+    print(line);
+}
+
+std::uint64_t droppedClients() {
+    return fixtures().dropped;
+}
+
+} // namespace host
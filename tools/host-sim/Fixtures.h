@@ -0,0 +1,27 @@
+#ifndef PLUGPP_EXAMPLE_TOOLS_HOSTSIM_FIXTURES_H
+#define PLUGPP_EXAMPLE_TOOLS_HOSTSIM_FIXTURES_H
+
+#include "Host.h"
+
+#include <cod4-plugpp/PluginApi.h>
+
+#include <cstdint>
+#include <string_view>
+
+/// Server structures handed to the plugin's callbacks
+namespace host {
+
+client_t& client(int num);
+gentity_t& entity(int num);
+
+/// Fills the client slot as if a player just sent the connect packet
+///
+/// The player gets the address 10.0.<num>.1, IDs derived from the slot number and a default userinfo.
+void connectClient(int num, std::string_view name);
+
+/// Frees the client slot
+void freeClient(int num);
+
+} // namespace host
+
+#endif // PLUGPP_EXAMPLE_TOOLS_HOSTSIM_FIXTURES_H
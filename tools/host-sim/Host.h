@@ -0,0 +1,78 @@
+#ifndef PLUGPP_EXAMPLE_TOOLS_HOSTSIM_HOST_H
+#define PLUGPP_EXAMPLE_TOOLS_HOSTSIM_HOST_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Server side of the plugin API as emulated by the host simulator
+///
+/// This header deliberately doesn't depend on the server's plugin headers - the C API is implemented in
+/// HostApi.cpp using plain types, while everything touching the server structures (client_t, gentity_t, ...)
+/// lives in Fixtures.cpp.
+namespace host {
+
+struct Cvar {
+    std::string name;
+    std::string string;
+    int integer = 0;
+    float value = 0.0f;
+
+    void set(std::string_view text);
+};
+
+/// Returns the console variable, creating it with the default value if it doesn't exist yet
+Cvar& registerCvar(std::string_view name, std::string_view defaultValue);
+
+/// Returns the console variable or nullptr if it doesn't exist
+Cvar* findCvar(std::string_view name);
+
+void setCvar(std::string_view name, std::string_view value);
+
+/// Executes a console command registered by the plugin
+/// @returns false if there is no such command.
+bool executeCommand(std::string_view line);
+
+using CommandFn = void (*)();
+void addCommand(const char* name, CommandFn fn);
+int commandArgc();
+const char* commandArgv(int i);
+
+/// Simulated server time in milliseconds
+int milliseconds();
+void setMilliseconds(int now);
+
+/// Console output of the plugin
+void print(const char* text);
+void setVerbose(bool verbose);
+std::uint64_t printedLines();
+
+/// Parameters of the GSC function or method the plugin gets called for, faked as their text
+void setScriptParams(std::vector<std::string> params);
+int scriptParamCount();
+const char* scriptParam(unsigned int i);
+
+/// Values returned to the script and errors raised by the plugin
+void addScriptResult();
+void scriptError(const char* message);
+std::uint64_t scriptResults();
+std::uint64_t scriptErrors();
+
+/// Out-of-band packets the plugin sends, handed to the sender installed by the simulator
+/// @param to Opaque netadr_t of the recipient.
+using PacketSender = void (*)(void* context, const void* to, const void* data, int length);
+void setPacketSender(PacketSender sender, void* context);
+void sendPacket(const void* to, const void* data, int length);
+std::uint64_t sentPackets();
+
+/// Client slots, implemented by the fixtures
+constexpr int SLOTS = 64;
+void* clientForNum(int num);
+int clientNumFor(const void* client);
+void dropClient(int num, const char* reason);
+std::uint64_t droppedClients();
+
+} // namespace host
+
+#endif // PLUGPP_EXAMPLE_TOOLS_HOSTSIM_HOST_H
@@ -0,0 +1,383 @@
+/// Implementation of the server's plugin API the example plugin imports
+///
+/// The plugin resolves these symbols from the executable when it gets loaded (the executable is linked with
+/// exported symbols). Only plain C types are used here, server structures are passed around as opaque
+/// pointers.
+
+#include "Host.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace host {
+
+namespace {
+
+    struct State {
+        std::map<std::string, std::unique_ptr<Cvar>, std::less<>> cvars;
+        std::map<std::string, CommandFn, std::less<>> commands;
+        std::vector<std::string> args;
+        int now = 0;
+        bool verbose = false;
+        std::uint64_t printed = 0;
+        std::vector<std::string> scriptParams;
+        std::uint64_t scriptResults = 0;
+        std::uint64_t scriptErrors = 0;
+        PacketSender sender = nullptr;
+        void* senderContext = nullptr;
+        std::uint64_t sent = 0;
+    };
+
+    State& state() {
+        static State instance;
+        return instance;
+    }
+
+} // namespace
+
+void Cvar::set(const std::string_view text) {
+    string = std::string(text);
+    integer = std::atoi(string.c_str());
+    value = static_cast<float>(std::atof(string.c_str()));
+}
+
+Cvar& registerCvar(const std::string_view name, const std::string_view defaultValue) {
+    auto& cvars = state().cvars;
+    auto it = cvars.find(name);
+    if (it == cvars.end()) {
+        auto cvar = std::make_unique<Cvar>();
+        cvar->name = std::string(name);
+        cvar->set(defaultValue);
+        it = cvars.emplace(std::string(name), std::move(cvar)).first;
+    }
+    return *it->second;
+}
+
+Cvar* findCvar(const std::string_view name) {
+    auto& cvars = state().cvars;
+    auto it = cvars.find(name);
+    return it == cvars.end() ? nullptr : it->second.get();
+}
+
+void setCvar(const std::string_view name, const std::string_view value) {
+    registerCvar(name, value).set(value);
+}
+
+bool executeCommand(const std::string_view line) {
+    auto& s = state();
+    s.args.clear();
+    std::istringstream stream{ std::string(line) };
+    for (std::string arg; stream >> arg;) {
+        s.args.push_back(std::move(arg));
+    }
+    if (s.args.empty()) {
+        return false;
+    }
+    auto it = s.commands.find(s.args[0]);
+    if (it == s.commands.end()) {
+        return false;
+    }
+    it->second();
+    return true;
+}
+
+void addCommand(const char* name, const CommandFn fn) {
+    state().commands[name] = fn;
+}
+
+int commandArgc() {
+    return static_cast<int>(state().args.size());
+}
+
+const char* commandArgv(const int i) {
+    const auto& args = state().args;
+    return i >= 0 && static_cast<std::size_t>(i) < args.size() ? args[i].c_str() : "";
+}
+
+int milliseconds() {
+    return state().now;
+}
+
+void setMilliseconds(const int now) {
+    state().now = now;
+}
+
+void print(const char* text) {
+    auto& s = state();
+    ++s.printed;
+    if (s.verbose) {
+        std::fputs(text, stdout);
+    }
+}
+
+void setVerbose(const bool verbose) {
+    state().verbose = verbose;
+}
+
+std::uint64_t printedLines() {
+    return state().printed;
+}
+
+void setScriptParams(std::vector<std::string> params) {
+    state().scriptParams = std::move(params);
+}
+
+int scriptParamCount() {
+    return static_cast<int>(state().scriptParams.size());
+}
+
+const char* scriptParam(const unsigned int i) {
+    const auto& params = state().scriptParams;
+    return i < params.size() ? params[i].c_str() : "";
+}
+
+void addScriptResult() {
+    ++state().scriptResults;
+}
+
+void scriptError(const char* message) {
+    ++state().scriptErrors;
+    // The server longjmps out of the script here, the plugin returns on its own right after the call
+    print(message);
+    print("\n");
+}
+
+std::uint64_t scriptResults() {
+    return state().scriptResults;
+}
+
+std::uint64_t scriptErrors() {
+    return state().scriptErrors;
+}
+
+void setPacketSender(const PacketSender sender, void* context) {
+    state().sender = sender;
+    state().senderContext = context;
+}
+
+void sendPacket(const void* to, const void* data, const int length) {
+    auto& s = state();
+    ++s.sent;
+    if (s.sender) {
+        s.sender(s.senderContext, to, data, length);
+    }
+}
+
+std::uint64_t sentPackets() {
+    return state().sent;
+}
+
+} // namespace host
+
+namespace {
+
+const char* weaponNames[] = {
+    "none", "m16_mp", "ak47_mp", "m40a3_mp", "mp5_mp", "deserteagle_mp", "frag_grenade_mp",
+};
+
+} // namespace
+
+extern "C" {
+
+void Plugin_Printf(const char* fmt, ...) {
+    char buffer[4096];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    host::print(buffer);
+}
+
+void Plugin_ChatPrintf(int slot, const char* fmt, ...) {
+    char buffer[1024];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    (void)slot;
+    host::print(buffer);
+}
+
+int Plugin_Milliseconds() {
+    return host::milliseconds();
+}
+
+int Plugin_GetLevelTime() {
+    return host::milliseconds();
+}
+
+int Plugin_GetServerTime() {
+    return host::milliseconds();
+}
+
+void* Plugin_Cvar_RegisterInt(
+    const char* name, int value, int min, int max, int flags, const char* description) {
+    (void)min;
+    (void)max;
+    (void)flags;
+    (void)description;
+    return &host::registerCvar(name, std::to_string(value));
+}
+
+void* Plugin_Cvar_RegisterBool(const char* name, int value, int flags, const char* description) {
+    (void)flags;
+    (void)description;
+    return &host::registerCvar(name, value ? "1" : "0");
+}
+
+void* Plugin_Cvar_RegisterFloat(
+    const char* name, float value, float min, float max, int flags, const char* description) {
+    (void)min;
+    (void)max;
+    (void)flags;
+    (void)description;
+    return &host::registerCvar(name, std::to_string(value));
+}
+
+void* Plugin_Cvar_RegisterString(const char* name, const char* value, int flags, const char* description) {
+    (void)flags;
+    (void)description;
+    return &host::registerCvar(name, value);
+}
+
+int Plugin_Cvar_GetInteger(const void* cvar) {
+    return static_cast<const host::Cvar*>(cvar)->integer;
+}
+
+int Plugin_Cvar_GetBoolean(const void* cvar) {
+    return static_cast<const host::Cvar*>(cvar)->integer != 0;
+}
+
+float Plugin_Cvar_GetValue(const void* cvar) {
+    return static_cast<const host::Cvar*>(cvar)->value;
+}
+
+const char* Plugin_Cvar_GetString(const void* cvar, char* buffer, std::size_t size) {
+    std::snprintf(buffer, size, "%s", static_cast<const host::Cvar*>(cvar)->string.c_str());
+    return buffer;
+}
+
+void Plugin_Cvar_VariableStringBuffer(const char* name, char* buffer, int size) {
+    const host::Cvar* cvar = host::findCvar(name);
+    std::snprintf(buffer, static_cast<std::size_t>(size), "%s", cvar ? cvar->string.c_str() : "");
+}
+
+int Plugin_Cvar_VariableIntegerValue(const char* name) {
+    const host::Cvar* cvar = host::findCvar(name);
+    return cvar ? cvar->integer : 0;
+}
+
+void Plugin_AddCommand(const char* name, host::CommandFn fn, int power) {
+    (void)power;
+    host::addCommand(name, fn);
+}
+
+void Plugin_RemoveCommand(const char* name) {
+    host::addCommand(name, nullptr);
+}
+
+int Plugin_Cmd_Argc() {
+    return host::commandArgc();
+}
+
+const char* Plugin_Cmd_Argv(int i) {
+    return host::commandArgv(i);
+}
+
+void* Plugin_GetClientForClientNum(int num) {
+    return host::clientForNum(num);
+}
+
+int Plugin_GetClientNumForClient(const void* client) {
+    return host::clientNumFor(client);
+}
+
+void Plugin_DropClient(unsigned int num, const char* reason) {
+    host::dropClient(static_cast<int>(num), reason);
+}
+
+int Plugin_Scr_GetNumParam() {
+    return host::scriptParamCount();
+}
+
+int Plugin_Scr_GetInt(unsigned int i) {
+    return std::atoi(host::scriptParam(i));
+}
+
+float Plugin_Scr_GetFloat(unsigned int i) {
+    return static_cast<float>(std::atof(host::scriptParam(i)));
+}
+
+const char* Plugin_Scr_GetString(unsigned int i) {
+    return host::scriptParam(i);
+}
+
+int Plugin_Scr_GetConstString(unsigned int i) {
+    (void)i;
+    return 0;
+}
+
+void Plugin_Scr_GetVector(unsigned int i, float (*v)[3]) {
+    (*v)[0] = static_cast<float>(std::atof(host::scriptParam(i)));
+    (*v)[1] = 0.0f;
+    (*v)[2] = 0.0f;
+}
+
+void* Plugin_Scr_GetEntity(unsigned int i) {
+    (void)i;
+    return nullptr;
+}
+
+int Plugin_Scr_GetType(unsigned int i) {
+    (void)i;
+    return 0;
+}
+
+int Plugin_Scr_GetFunc(unsigned int i) {
+    (void)i;
+    return 0;
+}
+
+void Plugin_Scr_AddInt(int value) {
+    (void)value;
+    host::addScriptResult();
+}
+
+void Plugin_Scr_AddFloat(float value) {
+    (void)value;
+    host::addScriptResult();
+}
+
+void Plugin_Scr_AddString(const char* value) {
+    (void)value;
+    host::addScriptResult();
+}
+
+void Plugin_Scr_AddVector(const float* value) {
+    (void)value;
+    host::addScriptResult();
+}
+
+void Plugin_Scr_Error(const char* message) {
+    host::scriptError(message);
+}
+
+int Plugin_NET_SendPacket(int sock, int length, const void* data, void* to) {
+    (void)sock;
+    host::sendPacket(to, data, length);
+    return 1;
+}
+
+const char* BG_WeaponName(int weapon) {
+    constexpr int count = static_cast<int>(sizeof(weaponNames) / sizeof(weaponNames[0]));
+    return weapon >= 0 && weapon < count ? weaponNames[weapon] : "unknown";
+}
+
+} // extern "C"
@@ -0,0 +1,803 @@
+/// Host simulator - loads the plugin and drives its callbacks without a CoD4X server
+///
+/// The simulated server runs on a virtual clock as fast as the plugin lets it. Every frame it calls OnFrame,
+/// feeds the move commands of all the connected clients and randomly generated chat messages, kills and
+/// connectionless queries. Each callback is timed and the latency percentiles are reported at the end, so
+/// the throughput of a plugin build can be compared offline.
+
+#include "Fixtures.h"
+
+#include "plugpp-example/perf/Histogram.h"
+#include "plugpp-example/trace/TraceFormat.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// Callbacks the server looks up in a loaded plugin, as declared by its plugin handler
+struct Callbacks {
+    int (*onInit)() = nullptr;
+    void (*onFrame)() = nullptr;
+    void (*onSpawnServer)() = nullptr;
+    void (*onExitLevel)() = nullptr;
+    void (*onTerminate)() = nullptr;
+    void (*onMessageSent)(char* message, int slot, qboolean* show, int mode) = nullptr;
+    void (*onPlayerConnect)(int slot,
+                            netadr_t* from,
+                            char* pbguid,
+                            char* userinfo,
+                            int authstatus,
+                            char* deniedmsg,
+                            int deniedmsgbufmaxlen) = nullptr;
+    void (*onPlayerDisconnect)(client_t* client, const char* reason) = nullptr;
+    void (*onPlayerGotAuthInfo)(netadr_t* from,
+                                std::uint64_t* playerid,
+                                std::uint64_t* steamid,
+                                char* rejectmsg,
+                                qboolean* returnNow,
+                                client_t* client) = nullptr;
+    void (*onPlayerGetBanStatus)(baninfo_t* baninfo, char* message, int len) = nullptr;
+    void (*onClientEnterWorld)(client_t* client) = nullptr;
+    void (*onClientUserinfoChanged)(client_t* client) = nullptr;
+    void (*onClientSpawn)(gentity_t* entity) = nullptr;
+    void (*onClientMoveCommand)(client_t* client, usercmd_t* ucmd) = nullptr;
+    void (*onPlayerKilled)(gentity_t* self,
+                           gentity_t* inflictor,
+                           gentity_t* attacker,
+                           int damage,
+                           int meansOfDeath,
+                           int weapon,
+                           hitLocation_t hitLocation) = nullptr;
+    void (*onUdpNetEvent)(netadr_t* from, void* data, int size, qboolean* returnNow) = nullptr;
+    void (*onUdpNetSend)(netadr_t* to, void* data, int len, qboolean* returnNow) = nullptr;
+};
+
+enum Callback : std::size_t {
+    ON_FRAME,
+    ON_SPAWN_SERVER,
+    ON_EXIT_LEVEL,
+    ON_MESSAGE_SENT,
+    ON_PLAYER_CONNECT,
+    ON_PLAYER_DISCONNECT,
+    ON_PLAYER_GOT_AUTH_INFO,
+    ON_PLAYER_GET_BAN_STATUS,
+    ON_CLIENT_ENTER_WORLD,
+    ON_CLIENT_USERINFO_CHANGED,
+    ON_CLIENT_SPAWN,
+    ON_CLIENT_MOVE_COMMAND,
+    ON_PLAYER_KILLED,
+    ON_UDP_NET_EVENT,
+    ON_UDP_NET_SEND,
+    CALLBACK_COUNT,
+};
+
+constexpr std::string_view CALLBACK_NAMES[] = {
+    "OnFrame",
+    "OnSpawnServer",
+    "OnExitLevel",
+    "OnMessageSent",
+    "OnPlayerConnect",
+    "OnPlayerDC",
+    "OnPlayerGotAuthInfo",
+    "OnPlayerGetBanStatus",
+    "OnClientEnterWorld",
+    "OnClientUserinfoChanged",
+    "OnClientSpawn",
+    "OnClientMoveCommand",
+    "OnPlayerKilled",
+    "OnUdpNetEvent",
+    "OnUdpNetSend",
+};
+static_assert(std::size(CALLBACK_NAMES) == CALLBACK_COUNT);
+
+struct Options {
+    std::string plugin = "bin/plugpp-example.so";
+    int clients = 64;
+    int fps = 20;
+    int cmdRate = 125;       ///< Move commands per client per second.
+    double seconds = 60.0;   ///< Simulated time.
+    double chatRate = 0.05;  ///< Chat messages per client per second.
+    double killRate = 1.0;   ///< Kills per second on the whole server.
+    double queryRate = 50.0; ///< getstatus packets per second.
+    int querySources = 16;   ///< Number of addresses the queries come from.
+    unsigned seed = 1;
+    bool verbose = false;
+    std::vector<std::pair<std::string, std::string>> cvars;
+    std::vector<std::string> traces; ///< Recorded traces replayed instead of the generated events.
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --plugin <path>         plugin to load (bin/plugpp-example.so)\n"
+                 "  --clients <n>           connected clients (64)\n"
+                 "  --fps <n>               server frames per second, sets sv_fps (20)\n"
+                 "  --cmd-rate <n>          move commands per client per second (125)\n"
+                 "  --seconds <n>           simulated seconds (60)\n"
+                 "  --chat-rate <n>         chat messages per client per second (0.05)\n"
+                 "  --kill-rate <n>         kills per second (1)\n"
+                 "  --query-rate <n>        getstatus packets per second (50)\n"
+                 "  --query-sources <n>     addresses sending the queries (16)\n"
+                 "  --seed <n>              seed of the event generator (1)\n"
+                 "  --set <cvar> <value>    sets a cvar before the plugin is loaded\n"
+                 "  --trace <path>          replays the recorded trace, may be repeated\n"
+                 "  --verbose               prints the plugin's console output\n",
+                 argv0);
+}
+
+bool parseOptions(const int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (arg == "--verbose") {
+            options.verbose = true;
+        } else if (arg == "--set" && i + 2 < argc) {
+            options.cvars.emplace_back(argv[i + 1], argv[i + 2]);
+            i += 2;
+        } else if (arg == "--trace" && (v = value())) {
+            options.traces.emplace_back(v);
+        } else if (arg == "--plugin" && (v = value())) {
+            options.plugin = v;
+        } else if (arg == "--clients" && (v = value())) {
+            options.clients = std::atoi(v);
+        } else if (arg == "--fps" && (v = value())) {
+            options.fps = std::atoi(v);
+        } else if (arg == "--cmd-rate" && (v = value())) {
+            options.cmdRate = std::atoi(v);
+        } else if (arg == "--seconds" && (v = value())) {
+            options.seconds = std::atof(v);
+        } else if (arg == "--chat-rate" && (v = value())) {
+            options.chatRate = std::atof(v);
+        } else if (arg == "--kill-rate" && (v = value())) {
+            options.killRate = std::atof(v);
+        } else if (arg == "--query-rate" && (v = value())) {
+            options.queryRate = std::atof(v);
+        } else if (arg == "--query-sources" && (v = value())) {
+            options.querySources = std::atoi(v);
+        } else if (arg == "--seed" && (v = value())) {
+            options.seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return options.clients >= 0 && options.clients <= host::SLOTS && options.fps > 0 &&
+           options.cmdRate >= 0 && options.seconds > 0.0 && options.querySources > 0;
+}
+
+template <typename Fn>
+void resolve(void* library, const char* name, Fn& fn) {
+    fn = reinterpret_cast<Fn>(dlsym(library, name));
+    if (!fn) {
+        std::fprintf(stderr, "Plugin doesn't export %s, skipped\n", name);
+    }
+}
+
+Callbacks resolveCallbacks(void* library) {
+    Callbacks c;
+    resolve(library, "OnInit", c.onInit);
+    resolve(library, "OnFrame", c.onFrame);
+    resolve(library, "OnSpawnServer", c.onSpawnServer);
+    resolve(library, "OnExitLevel", c.onExitLevel);
+    resolve(library, "OnTerminate", c.onTerminate);
+    resolve(library, "OnMessageSent", c.onMessageSent);
+    resolve(library, "OnPlayerConnect", c.onPlayerConnect);
+    resolve(library, "OnPlayerDC", c.onPlayerDisconnect);
+    resolve(library, "OnPlayerGotAuthInfo", c.onPlayerGotAuthInfo);
+    resolve(library, "OnPlayerGetBanStatus", c.onPlayerGetBanStatus);
+    resolve(library, "OnClientEnterWorld", c.onClientEnterWorld);
+    resolve(library, "OnClientUserinfoChanged", c.onClientUserinfoChanged);
+    resolve(library, "OnClientSpawn", c.onClientSpawn);
+    resolve(library, "OnClientMoveCommand", c.onClientMoveCommand);
+    resolve(library, "OnPlayerKilled", c.onPlayerKilled);
+    resolve(library, "OnUdpNetEvent", c.onUdpNetEvent);
+    resolve(library, "OnUdpNetSend", c.onUdpNetSend);
+    return c;
+}
+
+constexpr const char* CHAT_LINES[] = {
+    "gg",
+    "nice shot",
+    "^1where is everyone",
+    "lag!!",
+    "who is camping at B",
+    "rush A",
+    "what a noob",
+    "anyone up for a 1v1?",
+};
+
+/// The simulated server
+class Simulator {
+public:
+    Simulator(const Options& options, const Callbacks& callbacks)
+        : m_options(options)
+        , m_callbacks(callbacks)
+        , m_random(options.seed) {
+        m_frameMs = std::max(1, 1000 / options.fps);
+        host::setPacketSender(&Simulator::sendPluginPacket, this);
+    }
+
+    Simulator(const Simulator&) = delete;
+    Simulator& operator=(const Simulator&) = delete;
+
+    ~Simulator() { host::setPacketSender(nullptr, nullptr); }
+
+    void run() {
+        const auto start = std::chrono::steady_clock::now();
+        if (m_options.traces.empty()) {
+            simulate();
+        } else {
+            for (const auto& path : m_options.traces) {
+                std::ifstream file(path, std::ios::binary);
+                const std::vector<std::uint8_t> trace{ std::istreambuf_iterator<char>(file),
+                                                       std::istreambuf_iterator<char>() };
+                replay(trace.data(), trace.size());
+            }
+            for (int slot = 0; slot < host::SLOTS; ++slot) {
+                disconnect(slot, "EXE_DISCONNECTED");
+            }
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        m_wallNs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    void report() const {
+        std::uint64_t calls = 0;
+        std::uint64_t busyNs = 0;
+        for (const auto& histogram : m_callbackLatency) {
+            calls += histogram.count();
+            busyNs += histogram.sum();
+        }
+        const double wallSeconds = static_cast<double>(m_wallNs) / 1e9;
+        const double simulatedSeconds = static_cast<double>(host::milliseconds()) / 1000.0;
+
+        std::printf("simulated %.1f s (%llu frames) in %.3f s, %.1fx real time\n",
+                    simulatedSeconds,
+                    static_cast<unsigned long long>(m_frames.count()),
+                    wallSeconds,
+                    wallSeconds > 0.0 ? simulatedSeconds / wallSeconds : 0.0);
+        std::printf("%llu callbacks, %.0f callbacks/s, %.3f s inside the plugin\n",
+                    static_cast<unsigned long long>(calls),
+                    wallSeconds > 0.0 ? static_cast<double>(calls) / wallSeconds : 0.0,
+                    static_cast<double>(busyNs) / 1e9);
+        std::printf("%llu chat messages (%llu hidden), %llu kills, %llu queries (%llu dropped), "
+                    "%llu clients rejected, %llu dropped, %llu packets sent, %llu console lines\n\n",
+                    static_cast<unsigned long long>(m_chatMessages),
+                    static_cast<unsigned long long>(m_hiddenMessages),
+                    static_cast<unsigned long long>(m_kills),
+                    static_cast<unsigned long long>(m_queries),
+                    static_cast<unsigned long long>(m_droppedQueries),
+                    static_cast<unsigned long long>(m_rejectedClients),
+                    static_cast<unsigned long long>(host::droppedClients()),
+                    static_cast<unsigned long long>(host::sentPackets()),
+                    static_cast<unsigned long long>(host::printedLines()));
+
+        std::printf(
+            "%-26s %10s %10s %10s %10s %10s\n", "callback [us]", "calls", "mean", "p50", "p99", "max");
+        for (std::size_t i = 0; i < CALLBACK_COUNT; ++i) {
+            printRow(CALLBACK_NAMES[i], m_callbackLatency[i]);
+        }
+        printRow("frame total", m_frames);
+    }
+
+private:
+    static constexpr int MAX_PACKET = 1400;
+
+    /// Generates the events
+    void simulate() {
+        if (m_callbacks.onSpawnServer) {
+            timed(ON_SPAWN_SERVER, [&] { m_callbacks.onSpawnServer(); });
+        }
+        for (int slot = 0; slot < m_options.clients; ++slot) {
+            connect(slot);
+        }
+
+        const auto frames = static_cast<std::uint64_t>(m_options.seconds * 1000.0 / m_frameMs);
+        for (std::uint64_t i = 0; i < frames; ++i) {
+            frame();
+        }
+
+        for (int slot = 0; slot < m_options.clients; ++slot) {
+            disconnect(slot, "EXE_DISCONNECTED");
+        }
+        if (m_callbacks.onExitLevel) {
+            timed(ON_EXIT_LEVEL, [&] { m_callbacks.onExitLevel(); });
+        }
+    }
+
+    template <typename Fn>
+    void timed(const Callback callback, Fn&& fn) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const auto ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        m_callbackLatency[callback].record(ns);
+        m_frameNs += ns;
+    }
+
+    static void printRow(const std::string_view name, const example::perf::Histogram& histogram) {
+        std::printf("%-26.*s %10llu %10.1f %10.1f %10.1f %10.1f\n",
+                    static_cast<int>(name.size()),
+                    name.data(),
+                    static_cast<unsigned long long>(histogram.count()),
+                    histogram.mean() / 1e3,
+                    static_cast<double>(histogram.percentile(0.5)) / 1e3,
+                    static_cast<double>(histogram.percentile(0.99)) / 1e3,
+                    static_cast<double>(histogram.max()) / 1e3);
+    }
+
+    bool chance(const double probability) {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < probability;
+    }
+
+    int randomClient() {
+        return std::uniform_int_distribution<int>(0, std::max(0, m_options.clients - 1))(m_random);
+    }
+
+    bool active(const int slot) const { return host::client(slot).state == CS_ACTIVE; }
+
+    /// Advances the virtual clock by one frame and calls OnFrame
+    void tick() {
+        host::setMilliseconds(host::milliseconds() + m_frameMs);
+        if (m_callbacks.onFrame) {
+            timed(ON_FRAME, [&] { m_callbacks.onFrame(); });
+        }
+        m_frames.record(m_frameNs);
+        m_frameNs = 0;
+    }
+
+    void connect(const int slot) {
+        if (beginConnect(slot, nullptr) && authenticate(slot)) {
+            enterWorld(slot);
+            userinfoChanged(slot);
+            spawn(slot);
+        }
+    }
+
+    /// Fills the slot and lets the plugin accept or reject the connection
+    bool beginConnect(const int slot, const netadr_t* from) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "player%d", slot);
+        host::connectClient(slot, name);
+        client_t* cl = &host::client(slot);
+        if (from) {
+            cl->netchan.remoteAddress = *from;
+        }
+
+        char denied[1024] = {};
+        if (m_callbacks.onPlayerConnect) {
+            char guid[33] = {};
+            timed(ON_PLAYER_CONNECT, [&] {
+                m_callbacks.onPlayerConnect(
+                    slot, &cl->netchan.remoteAddress, guid, cl->userinfo, 0, denied, sizeof(denied));
+            });
+        }
+        return !denied[0] || reject(slot);
+    }
+
+    /// Passes the authentication and ban checks, frames advance while the plugin parks the client
+    bool authenticate(const int slot) {
+        client_t* cl = &host::client(slot);
+        if (cl->state == CS_FREE) {
+            return false;
+        }
+        char denied[1024] = {};
+        constexpr int MAX_AUTH_FRAMES = 1000;
+        qboolean returnNow = 1;
+        for (int i = 0; m_callbacks.onPlayerGotAuthInfo && !denied[0] && returnNow && i < MAX_AUTH_FRAMES;
+             ++i) {
+            returnNow = 0;
+            timed(ON_PLAYER_GOT_AUTH_INFO, [&] {
+                m_callbacks.onPlayerGotAuthInfo(
+                    &cl->netchan.remoteAddress, &cl->playerid, &cl->steamid, denied, &returnNow, cl);
+            });
+            if (returnNow) {
+                tick();
+            }
+        }
+
+        if (m_callbacks.onPlayerGetBanStatus && !denied[0]) {
+            baninfo_t banInfo = {};
+            banInfo.playerid = cl->playerid;
+            banInfo.steamid = cl->steamid;
+            banInfo.adr = cl->netchan.remoteAddress;
+            std::snprintf(banInfo.playername, sizeof(banInfo.playername), "%s", cl->name);
+            timed(ON_PLAYER_GET_BAN_STATUS,
+                  [&] { m_callbacks.onPlayerGetBanStatus(&banInfo, denied, sizeof(denied)); });
+        }
+
+        if (denied[0] || cl->state == CS_FREE) {
+            return reject(slot);
+        }
+        cl->state = CS_PRIMED;
+        return true;
+    }
+
+    bool reject(const int slot) {
+        ++m_rejectedClients;
+        host::freeClient(slot);
+        return false;
+    }
+
+    void enterWorld(const int slot) {
+        client_t* cl = &host::client(slot);
+        if (cl->state == CS_FREE) {
+            return;
+        }
+        cl->state = CS_ACTIVE;
+        if (m_callbacks.onClientEnterWorld) {
+            timed(ON_CLIENT_ENTER_WORLD, [&] { m_callbacks.onClientEnterWorld(cl); });
+        }
+    }
+
+    void userinfoChanged(const int slot) {
+        if (m_callbacks.onClientUserinfoChanged && host::client(slot).state != CS_FREE) {
+            client_t* cl = &host::client(slot);
+            timed(ON_CLIENT_USERINFO_CHANGED, [&] { m_callbacks.onClientUserinfoChanged(cl); });
+        }
+    }
+
+    void disconnect(const int slot, const char* reason) {
+        if (host::client(slot).state == CS_FREE) {
+            return;
+        }
+        if (m_callbacks.onPlayerDisconnect) {
+            timed(ON_PLAYER_DISCONNECT, [&] { m_callbacks.onPlayerDisconnect(&host::client(slot), reason); });
+        }
+        host::freeClient(slot);
+    }
+
+    void spawn(const int slot) {
+        if (m_callbacks.onClientSpawn && active(slot)) {
+            timed(ON_CLIENT_SPAWN, [&] { m_callbacks.onClientSpawn(&host::entity(slot)); });
+        }
+    }
+
+    void frame() {
+        const int now = host::milliseconds();
+
+        // Move commands - spread evenly over the frame like the clients would send them
+        m_commandDebt += static_cast<double>(m_options.cmdRate) * m_frameMs / 1000.0;
+        const auto commands = static_cast<int>(m_commandDebt);
+        m_commandDebt -= commands;
+        for (int slot = 0; slot < m_options.clients && m_callbacks.onClientMoveCommand; ++slot) {
+            for (int i = 0; i < commands && active(slot); ++i) {
+                move(slot, now - m_frameMs + (i + 1) * m_frameMs / commands);
+            }
+        }
+
+        for (int slot = 0; slot < m_options.clients; ++slot) {
+            if (active(slot) && chance(m_options.chatRate * m_frameMs / 1000.0)) {
+                chat(slot);
+            }
+        }
+
+        if (m_options.clients > 1 && chance(m_options.killRate * m_frameMs / 1000.0)) {
+            kill(randomClient(), randomClient());
+        }
+
+        m_queryDebt += m_options.queryRate * m_frameMs / 1000.0;
+        for (; m_queryDebt >= 1.0; m_queryDebt -= 1.0) {
+            query();
+        }
+
+        tick();
+    }
+
+    void move(const int slot, const int serverTime) {
+        auto& view = m_views[slot];
+        view[0] += std::normal_distribution<double>(0.0, 40.0)(m_random);
+        view[1] += std::normal_distribution<double>(0.0, 120.0)(m_random);
+
+        usercmd_t cmd = {};
+        cmd.serverTime = serverTime;
+        cmd.buttons = chance(0.1) ? 1 : 0;
+        cmd.angles[0] = static_cast<int>(std::lround(view[0])) & 0xFFFF;
+        cmd.angles[1] = static_cast<int>(std::lround(view[1])) & 0xFFFF;
+        cmd.weapon = 1;
+        cmd.forwardmove = 127;
+        sendMove(slot, cmd);
+    }
+
+    void chat(const int slot) {
+        std::uniform_int_distribution<std::size_t> pick(0, std::size(CHAT_LINES) - 1);
+        sendChat(slot, CHAT_LINES[pick(m_random)], 0);
+    }
+
+    void kill(const int victim, const int attacker) {
+        if (!active(victim) || !active(attacker)) {
+            return;
+        }
+        const int weapon = std::uniform_int_distribution<int>(1, 6)(m_random);
+        const auto hitLocation = chance(0.2) ? HITLOC_HEAD : HITLOC_NONE;
+        sendKill(victim, attacker, weapon, 1, hitLocation, 100);
+    }
+
+    void query() {
+        netadr_t from = {};
+        from.type = NA_IP;
+        from.port = 28960;
+        const int source = std::uniform_int_distribution<int>(0, m_options.querySources - 1)(m_random);
+        from.ip[0] = 198;
+        from.ip[1] = 51;
+        from.ip[2] = static_cast<byte>(source >> 8);
+        from.ip[3] = static_cast<byte>(source);
+
+        char packet[] = "\xFF\xFF\xFF\xFFgetstatus 12345";
+        if (receivePacket(from, packet, static_cast<int>(sizeof(packet) - 1))) {
+            char response[] = "\xFF\xFF\xFF\xFFstatusResponse\n\\sv_hostname\\host-sim\\mapname\\mp_crash\n";
+            sendPacket(from, response, static_cast<int>(sizeof(response) - 1));
+        }
+    }
+
+    void sendMove(const int slot, usercmd_t& cmd) {
+        if (m_callbacks.onClientMoveCommand && active(slot)) {
+            client_t* cl = &host::client(slot);
+            timed(ON_CLIENT_MOVE_COMMAND, [&] { m_callbacks.onClientMoveCommand(cl, &cmd); });
+        }
+    }
+
+    void sendChat(const int slot, const std::string_view text, const int mode) {
+        if (!m_callbacks.onMessageSent || !active(slot)) {
+            return;
+        }
+        char message[256];
+        std::snprintf(message, sizeof(message), "%.*s", static_cast<int>(text.size()), text.data());
+        qboolean show = 1;
+        timed(ON_MESSAGE_SENT, [&] { m_callbacks.onMessageSent(message, slot, &show, mode); });
+        ++m_chatMessages;
+        if (!show) {
+            ++m_hiddenMessages;
+        }
+    }
+
+    /// The attacker may be an invalid slot for kills by the world
+    void sendKill(const int victim,
+                  const int attacker,
+                  const int weapon,
+                  const int meansOfDeath,
+                  const hitLocation_t hitLocation,
+                  const int damage) {
+        if (!m_callbacks.onPlayerKilled || !active(victim)) {
+            return;
+        }
+        gentity_t* self = &host::entity(victim);
+        gentity_t* other = attacker >= 0 && attacker < host::SLOTS ? &host::entity(attacker) : nullptr;
+        timed(ON_PLAYER_KILLED, [&] {
+            m_callbacks.onPlayerKilled(self, other, other, damage, meansOfDeath, weapon, hitLocation);
+        });
+        ++m_kills;
+        spawn(victim);
+    }
+
+    /// @returns false if the plugin dropped the packet.
+    bool receivePacket(netadr_t from, char* data, const int size) {
+        if (!m_callbacks.onUdpNetEvent) {
+            return true;
+        }
+        qboolean returnNow = 0;
+        timed(ON_UDP_NET_EVENT, [&] { m_callbacks.onUdpNetEvent(&from, data, size, &returnNow); });
+        ++m_queries;
+        if (returnNow) {
+            ++m_droppedQueries;
+        }
+        return !returnNow;
+    }
+
+    void sendPacket(netadr_t to, char* data, const int size) {
+        if (m_callbacks.onUdpNetSend) {
+            qboolean returnNow = 0;
+            timed(ON_UDP_NET_SEND, [&] { m_callbacks.onUdpNetSend(&to, data, size, &returnNow); });
+        }
+    }
+
+    /// Sends a packet of the plugin itself through the send hook, as the server's NET_SendPacket does
+    static void sendPluginPacket(void* self, const void* to, const void* data, const int length) {
+        char packet[MAX_PACKET];
+        const int size = std::min(length, MAX_PACKET);
+        std::memcpy(packet, data, static_cast<std::size_t>(size));
+        static_cast<Simulator*>(self)->sendPacket(*static_cast<const netadr_t*>(to), packet, size);
+    }
+
+    /// Drives the callbacks with the recorded events, frames are advanced to the times of the events
+    void replay(const std::uint8_t* data, const std::size_t size) {
+        namespace trace = example::trace;
+        const bool valid = trace::forEachEvent(data, size, [&](const trace::Event& event) {
+            if (!m_traceStarted) {
+                m_traceStarted = true;
+                m_traceOffset = event.time - static_cast<std::uint64_t>(host::milliseconds());
+            }
+            while (static_cast<std::uint64_t>(host::milliseconds()) + m_traceOffset < event.time) {
+                tick();
+            }
+            dispatch(event);
+        });
+        if (!valid) {
+            std::fprintf(stderr, "Not a trace file, skipped\n");
+        }
+    }
+
+    void dispatch(const example::trace::Event& event) {
+        using example::trace::RecordType;
+        const int slot = event.slot;
+        if (slot >= host::SLOTS) {
+            return;
+        }
+        switch (event.type) {
+        case RecordType::SPAWN_SERVER:
+            if (m_callbacks.onSpawnServer) {
+                timed(ON_SPAWN_SERVER, [&] { m_callbacks.onSpawnServer(); });
+            }
+            break;
+        case RecordType::EXIT_LEVEL:
+            if (m_callbacks.onExitLevel) {
+                timed(ON_EXIT_LEVEL, [&] { m_callbacks.onExitLevel(); });
+            }
+            break;
+        case RecordType::CONNECT: {
+            const netadr_t from = toNetadr(event.address);
+            beginConnect(slot, &from);
+            break;
+        }
+        case RecordType::AUTH:
+            if (host::client(slot).state != CS_FREE) {
+                host::client(slot).playerid = event.playerid;
+                host::client(slot).steamid = event.steamid;
+                authenticate(slot);
+            }
+            break;
+        case RecordType::DISCONNECT:
+            disconnect(slot, "EXE_DISCONNECTED");
+            break;
+        case RecordType::ENTER_WORLD:
+            enterWorld(slot);
+            break;
+        case RecordType::USERINFO:
+            userinfoChanged(slot);
+            break;
+        case RecordType::SPAWN:
+            spawn(slot);
+            break;
+        case RecordType::CHAT:
+            sendChat(slot, event.text, event.mode);
+            break;
+        case RecordType::KILL:
+            sendKill(slot,
+                     event.attacker,
+                     event.weapon,
+                     event.meansOfDeath,
+                     static_cast<hitLocation_t>(event.hitLocation),
+                     event.damage);
+            break;
+        case RecordType::MOVE: {
+            usercmd_t cmd = {};
+            cmd.serverTime = event.command.serverTime;
+            cmd.buttons = event.command.buttons;
+            std::memcpy(cmd.angles, event.command.angles, sizeof(cmd.angles));
+            cmd.weapon = event.command.weapon;
+            cmd.forwardmove = static_cast<char>(event.command.forwardmove);
+            cmd.rightmove = static_cast<char>(event.command.rightmove);
+            sendMove(slot, cmd);
+            break;
+        }
+        case RecordType::UDP_IN: {
+            // Only the kind and the size of the packet is recorded
+            static constexpr std::string_view COMMANDS[] = { "getstatus", "getchallenge", "rcon" };
+            char packet[MAX_PACKET] = {};
+            const int size = static_cast<int>(std::min<std::uint32_t>(event.size, sizeof(packet)));
+            const std::size_t packetClass = event.flags & (example::trace::Event::DROPPED - 1);
+            if (packetClass < std::size(COMMANDS)) {
+                std::memset(packet, 0xFF, 4);
+                std::memcpy(packet + 4, COMMANDS[packetClass].data(), COMMANDS[packetClass].size());
+            }
+            receivePacket(toNetadr(event.address), packet, size);
+            break;
+        }
+        case RecordType::UDP_OUT: {
+            char packet[MAX_PACKET] = {};
+            const int size = static_cast<int>(std::min<std::uint32_t>(event.size, sizeof(packet)));
+            sendPacket(netadr_t{}, packet, size);
+            break;
+        }
+        case RecordType::COUNT:
+            break;
+        }
+    }
+
+    static netadr_t toNetadr(const example::trace::Address& address) {
+        netadr_t adr = {};
+        adr.port = address.port;
+        if (address.family == 4) {
+            adr.type = NA_IP;
+            std::memcpy(adr.ip, address.ip.data(), 4);
+        } else if (address.family == 6) {
+            adr.type = NA_IP6;
+            std::memcpy(adr.ip6, address.ip.data(), 16);
+        } else {
+            adr.type = NA_BOT;
+        }
+        return adr;
+    }
+
+    const Options& m_options;
+    const Callbacks& m_callbacks;
+    std::mt19937 m_random;
+    int m_frameMs;
+    double m_commandDebt = 0.0;
+    double m_queryDebt = 0.0;
+    std::array<std::array<double, 2>, host::SLOTS> m_views{};
+
+    std::array<example::perf::Histogram, CALLBACK_COUNT> m_callbackLatency;
+    example::perf::Histogram m_frames;
+    std::uint64_t m_frameNs = 0;
+    std::uint64_t m_wallNs = 0;
+
+    std::uint64_t m_chatMessages = 0;
+    std::uint64_t m_hiddenMessages = 0;
+    std::uint64_t m_kills = 0;
+    std::uint64_t m_queries = 0;
+    std::uint64_t m_droppedQueries = 0;
+    std::uint64_t m_rejectedClients = 0;
+
+    bool m_traceStarted = false;
+    std::uint64_t m_traceOffset = 0; ///< Recorded time minus the simulated time.
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    host::setVerbose(options.verbose);
+    host::setCvar("sv_fps", std::to_string(options.fps));
+    host::setCvar("sv_maxclients", std::to_string(host::SLOTS));
+    for (const auto& [name, value] : options.cvars) {
+        host::setCvar(name, value);
+    }
+
+    void* library = dlopen(options.plugin.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+        std::fprintf(stderr, "Can't load the plugin: %s\n", dlerror());
+        return 1;
+    }
+    const Callbacks callbacks = resolveCallbacks(library);
+    if (callbacks.onInit && callbacks.onInit() < 0) {
+        std::fprintf(stderr, "The plugin failed to initialize\n");
+        return 1;
+    }
+
+    {
+        // Heap allocated, the per-callback histograms are a few dozen kilobytes
+        auto simulator = std::make_unique<Simulator>(options, callbacks);
+        simulator->run();
+        simulator->report();
+    }
+
+    if (callbacks.onTerminate) {
+        callbacks.onTerminate();
+    }
+    dlclose(library);
+    return 0;
+}
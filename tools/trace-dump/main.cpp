@@ -0,0 +1,189 @@
+/// Decodes the traces recorded by the plugin (see the example_trace cvar)
+///
+/// Prints every record as a line of text, or with --summary just the number of records of each type.
+
+#include "plugpp-example/trace/TraceFormat.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace {
+
+namespace trace = example::trace;
+
+std::string toString(const trace::Address& address) {
+    char text[64];
+    if (address.family == 4) {
+        std::snprintf(text,
+                      sizeof(text),
+                      "%u.%u.%u.%u",
+                      address.ip[0],
+                      address.ip[1],
+                      address.ip[2],
+                      address.ip[3]);
+    } else if (address.family == 6) {
+        int length = 0;
+        for (std::size_t i = 0; i < 16; i += 2) {
+            length += std::snprintf(text + length,
+                                    sizeof(text) - static_cast<std::size_t>(length),
+                                    i ? ":%02x%02x" : "%02x%02x",
+                                    address.ip[i],
+                                    address.ip[i + 1]);
+        }
+    } else {
+        return "-";
+    }
+    return text;
+}
+
+void print(const trace::Event& e) {
+    using trace::RecordType;
+    std::printf("%llu %.*s",
+                static_cast<unsigned long long>(e.time),
+                static_cast<int>(trace::RECORD_NAMES[static_cast<std::size_t>(e.type)].size()),
+                trace::RECORD_NAMES[static_cast<std::size_t>(e.type)].data());
+    switch (e.type) {
+    case RecordType::SPAWN_SERVER:
+    case RecordType::EXIT_LEVEL:
+    case RecordType::COUNT:
+        break;
+    case RecordType::CONNECT:
+        std::printf(" slot=%u from=%s", e.slot, toString(e.address).c_str());
+        break;
+    case RecordType::AUTH:
+        std::printf(" slot=%u playerid=%llu steamid=%llu%s",
+                    e.slot,
+                    static_cast<unsigned long long>(e.playerid),
+                    static_cast<unsigned long long>(e.steamid),
+                    e.flags & trace::Event::REJECTED ? " rejected" : "");
+        break;
+    case RecordType::DISCONNECT:
+    case RecordType::ENTER_WORLD:
+    case RecordType::USERINFO:
+    case RecordType::SPAWN:
+        std::printf(" slot=%u", e.slot);
+        break;
+    case RecordType::CHAT:
+        std::printf(" slot=%u mode=%d%s text=\"%.*s\"",
+                    e.slot,
+                    e.mode,
+                    e.flags & trace::Event::HIDDEN ? " hidden" : "",
+                    static_cast<int>(e.text.size()),
+                    e.text.data());
+        break;
+    case RecordType::KILL:
+        std::printf(" victim=%u attacker=%u weapon=%u mod=%u hitloc=%u damage=%d",
+                    e.slot,
+                    e.attacker,
+                    e.weapon,
+                    e.meansOfDeath,
+                    e.hitLocation,
+                    e.damage);
+        break;
+    case RecordType::MOVE:
+        std::printf(" slot=%u time=%d buttons=%#x angles=%d,%d,%d weapon=%u move=%d,%d",
+                    e.slot,
+                    e.command.serverTime,
+                    static_cast<unsigned>(e.command.buttons),
+                    e.command.angles[0],
+                    e.command.angles[1],
+                    e.command.angles[2],
+                    e.command.weapon,
+                    e.command.forwardmove,
+                    e.command.rightmove);
+        break;
+    case RecordType::UDP_IN:
+        std::printf(" size=%u class=%u from=%s%s",
+                    e.size,
+                    e.flags & (trace::Event::DROPPED - 1),
+                    toString(e.address).c_str(),
+                    e.flags & trace::Event::DROPPED ? " dropped" : "");
+        break;
+    case RecordType::UDP_OUT:
+        std::printf(" size=%u", e.size);
+        break;
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool summary = false;
+    int files = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--summary") {
+            summary = true;
+            continue;
+        }
+        ++files;
+
+        const int fd = ::open(argv[i], O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        if (fd < 0 || ::fstat(fd, &st) != 0 || st.st_size == 0) {
+            std::fprintf(stderr, "Can't read '%s'\n", argv[i]);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return 1;
+        }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            std::fprintf(stderr, "Can't map '%s'\n", argv[i]);
+            return 1;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+
+        std::array<std::uint64_t, static_cast<std::size_t>(trace::RecordType::COUNT)> counts{};
+        std::uint64_t first = 0;
+        std::uint64_t last = 0;
+        std::uint64_t records = 0;
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        const bool valid = trace::forEachEvent(bytes, size, [&](const trace::Event& e) {
+            if (records++ == 0) {
+                first = e.time;
+            }
+            last = e.time;
+            ++counts[static_cast<std::size_t>(e.type)];
+            if (!summary) {
+                print(e);
+            }
+        });
+        ::munmap(data, size);
+        if (!valid) {
+            std::fprintf(stderr, "'%s' is not a trace file\n", argv[i]);
+            return 1;
+        }
+
+        if (summary) {
+            std::printf("%s: %llu records in %llu bytes (%.1f bytes per record) over %.1f s\n",
+                        argv[i],
+                        static_cast<unsigned long long>(records),
+                        static_cast<unsigned long long>(size),
+                        records ? static_cast<double>(size) / static_cast<double>(records) : 0.0,
+                        static_cast<double>(last - first) / 1000.0);
+            for (std::size_t type = 1; type < counts.size(); ++type) {
+                std::printf("  %-12.*s %llu\n",
+                            static_cast<int>(trace::RECORD_NAMES[type].size()),
+                            trace::RECORD_NAMES[type].data(),
+                            static_cast<unsigned long long>(counts[type]));
+            }
+        }
+    }
+    if (files == 0) {
+        std::fprintf(stderr, "Usage: %s [--summary] <trace>...\n", argv[0]);
+        return 2;
+    }
+    return 0;
+}